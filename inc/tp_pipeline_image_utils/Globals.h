@@ -126,6 +126,10 @@ TDP_DECLARE_ID(                    calcAlphaSID,                       "Calc alp
 TDP_DECLARE_ID(                     calcByteSID,                        "Calc byte")
 TDP_DECLARE_ID(                            xSID,                                "X")
 TDP_DECLARE_ID(                            ySID,                                "Y")
+TDP_DECLARE_ID(                 outputFormatSID,                    "Output format")
+TDP_DECLARE_ID(                       engineSID,                           "Engine")
+TDP_DECLARE_ID(                  namedInputsSID,                     "Named inputs")
+TDP_DECLARE_ID(                   borderModeSID,                      "Border mode")
 
 //##################################################################################################
 //! Add the step delegates that this module provides to the StepDelegateMap
@@ -134,6 +138,10 @@ void createStepDelegates(tp_pipeline::StepDelegateMap& stepDelegates, const tp_d
 //##################################################################################################
 TPPixel makeColor(size_t index);
 
+//##################################################################################################
+//! Colors for 32 bit labels, the first 256 match makeColor() and the rest are hashed.
+TPPixel makeLabelColor(uint32_t label);
+
 //##################################################################################################
 void validateColor(tp_pipeline::Parameter& param, const TPPixel& color);
 
@@ -0,0 +1,50 @@
+#ifndef tp_pipeline_image_utils_ImageMembers_h
+#define tp_pipeline_image_utils_ImageMembers_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include <memory>
+
+namespace tp_image_utils
+{
+class ColorMap;
+class ByteMap;
+}
+
+namespace tp_data
+{
+class AbstractMember;
+}
+
+namespace tp_pipeline
+{
+class StepInput;
+}
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! Returns the color image held by a member or nullptr.
+/*!
+Plain color maps are referenced without a copy. Indexed and padded images are expanded into a
+copy that is owned by the returned pointer and released with it, nothing is cached on the member.
+Keep the returned pointer alive for as long as the image is used.
+*/
+std::shared_ptr<const tp_image_utils::ColorMap> colorMapFromMember(const tp_data::AbstractMember* member);
+
+//##################################################################################################
+//! Find a named color image in the step input, see colorMapFromMember().
+std::shared_ptr<const tp_image_utils::ColorMap> findColorMap(const tp_pipeline::StepInput& input, const std::string& name);
+
+//##################################################################################################
+//! Returns the byte map held by a member or nullptr, see colorMapFromMember().
+std::shared_ptr<const tp_image_utils::ByteMap> byteMapFromMember(const tp_data::AbstractMember* member);
+
+//##################################################################################################
+//! Find a named byte map in the step input, see byteMapFromMember().
+std::shared_ptr<const tp_image_utils::ByteMap> findByteMap(const tp_pipeline::StepInput& input, const std::string& name);
+
+}
+
+#endif
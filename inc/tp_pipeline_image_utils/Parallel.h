@@ -0,0 +1,35 @@
+#ifndef tp_pipeline_image_utils_Parallel_h
+#define tp_pipeline_image_utils_Parallel_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include <functional>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! The number of threads that parallelFor will use.
+size_t threadCount();
+
+//##################################################################################################
+//! Split [0, count) into contiguous ranges and process them on a shared pool of threads.
+/*!
+The ranges are at least minRange long and are handed out in order, so range i always covers lower
+indices than range i+1. The calling thread processes ranges too and the call returns once all ranges
+have been processed. The pool threads are started on first use and reused by every later call.
+
+If the closure throws, ranges that have not started yet are skipped and the first exception is
+rethrown on the calling thread. Calls made from inside a closure run serially as a single range.
+
+\param count The number of items to process, typically the number of rows in an image.
+\param minRange The smallest range worth starting a thread for.
+\param closure Called with [begin, end) and the index of the range.
+*/
+void parallelFor(size_t count,
+                 size_t minRange,
+                 const std::function<void(size_t begin, size_t end, size_t range)>& closure);
+
+}
+
+#endif
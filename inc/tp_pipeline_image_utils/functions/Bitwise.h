@@ -0,0 +1,37 @@
+#ifndef tp_pipeline_image_utils_Bitwise_h
+#define tp_pipeline_image_utils_Bitwise_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+
+#include "tp_image_utils_functions/Bitwise.h"
+
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! A two input bitwise function, bit (p<<1 | q) holds the output for input bits p and q.
+/*!
+For example AND is 0b1000, OR is 0b1110 and XOR is 0b0110.
+*/
+using TruthTable = uint8_t;
+
+//##################################################################################################
+//! Find the truth table of a tp_image_utils_functions operation by applying it to bit patterns.
+/*!
+\returns false if the operation does not act on each bit on its own.
+*/
+bool truthTable(tp_image_utils_functions::LogicOp operation, TruthTable& table);
+
+//##################################################################################################
+//! dst = f(...f(f(dst, q0), q1)..., qn), 8 bytes at a time, operands must be the same size as dst.
+void bitwiseInPlace(tp_image_utils::ByteMap& dst,
+                    const std::vector<const tp_image_utils::ByteMap*>& operands,
+                    TruthTable table);
+
+}
+
+#endif
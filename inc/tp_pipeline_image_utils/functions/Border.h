@@ -0,0 +1,70 @@
+#ifndef tp_pipeline_image_utils_Border_h
+#define tp_pipeline_image_utils_Border_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+#include "tp_image_utils/ColorMap.h"
+
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! How pixels outside of an image are read.
+enum class BorderMode
+{
+  Constant, //!< A fixed value.
+  Clamp,    //!< The nearest edge pixel.
+  Reflect   //!< Mirrored about the edge, the edge pixel is repeated so -1 reads 0 and -2 reads 1.
+};
+
+//##################################################################################################
+std::vector<std::string> borderModes();
+
+//##################################################################################################
+BorderMode borderModeFromString(const std::string& mode);
+
+//##################################################################################################
+//! Map a coordinate that may lie outside [0, size) back into the image.
+/*!
+\returns The mapped coordinate, or -1 in Constant mode when c is outside the image.
+*/
+inline int64_t borderCoordinate(int64_t c, size_t size, BorderMode mode)
+{
+  auto s = int64_t(size);
+  if(c>=0 && c<s)
+    return c;
+
+  switch(mode)
+  {
+  case BorderMode::Constant:
+    return -1;
+
+  case BorderMode::Clamp:
+    return (c<0)?0:(s-1);
+
+  case BorderMode::Reflect:
+  {
+    int64_t period = s*2;
+    c %= period;
+    if(c<0)
+      c += period;
+    return (c<s)?c:(period-1-c);
+  }
+  }
+
+  return -1;
+}
+
+//##################################################################################################
+//! Build an image with a border of the given width on each side, rows are filled in parallel.
+tp_image_utils::ColorMap padColorMap(const tp_image_utils::ColorMap& src, size_t border, BorderMode mode, TPPixel color);
+
+//##################################################################################################
+tp_image_utils::ByteMap padByteMap(const tp_image_utils::ByteMap& src, size_t border, BorderMode mode, uint8_t value);
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef tp_pipeline_image_utils_CellSegment_h
+#define tp_pipeline_image_utils_CellSegment_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! A label per pixel, 0 is background.
+struct LabelMap
+{
+  size_t width{0};
+  size_t height{0};
+  std::vector<uint32_t> labels;
+};
+
+//##################################################################################################
+enum class CellGrowth
+{
+  Box,  //!< Cells grow into all 8 neighbours each pass, so they grow as squares.
+  Flood //!< Cells grow into their 4 neighbours each pass.
+};
+
+//##################################################################################################
+struct FrontierCellSegmentParameters
+{
+  size_t distanceFieldRadius{512}; //!< Distances are clipped to this.
+  size_t minRadius{20};            //!< Seeds need at least this distance to the background.
+  size_t maxInitialCells{40};      //!< Keep at most this many seeds, largest first.
+  size_t growCellsPasses{500};     //!< Cells stop growing after this many passes.
+  CellGrowth growth{CellGrowth::Box};
+};
+
+//##################################################################################################
+//! Segment the non zero pixels of a mono image into cells with 32 bit labels.
+/*!
+Seeds are distance field maxima painted as discs, or the non zero pixels of labels if it is given.
+Cells grow from their boundaries, the lowest label wins ties. The cells differ from cellSegment().
+*/
+LabelMap frontierCellSegment(const tp_image_utils::ByteMap& src,
+                             const LabelMap* labels,
+                             const FrontierCellSegmentParameters& params);
+
+//##################################################################################################
+//! Widen a byte map of labels.
+LabelMap toLabelMap(const tp_image_utils::ByteMap& src);
+
+//##################################################################################################
+//! Narrow a label map to bytes, labels above 255 are clamped to 255.
+tp_image_utils::ByteMap toByteMap(const LabelMap& src);
+
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef tp_pipeline_image_utils_Contours_h
+#define tp_pipeline_image_utils_Contours_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+
+#include <array>
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! The outline of one 4 connected region of a label map and the outlines of its holes.
+struct LabelPolygon
+{
+  uint8_t label{0};
+  std::vector<std::array<float, 2>> outline;
+  std::vector<std::vector<std::array<float, 2>>> holes;
+};
+
+//##################################################################################################
+//! Trace the 4 connected regions of each non zero value in a label map with marching squares.
+/*!
+Vertices are the mid points between pixel centers so neighbouring regions share them. Contours are
+simplified with Douglas-Peucker if tolerance is greater than 0.
+*/
+std::vector<LabelPolygon> traceLabelPolygons(const tp_image_utils::ByteMap& src, float tolerance);
+
+//##################################################################################################
+//! Number the 4 connected regions of each non zero value in raster order from 1, 0 pixels get 0.
+/*!
+\param count Set to the number of regions found.
+*/
+std::vector<uint32_t> labelComponents(const tp_image_utils::ByteMap& src, size_t& count);
+
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef tp_pipeline_image_utils_DrawMask_h
+#define tp_pipeline_image_utils_DrawMask_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+#include "tp_image_utils/ColorMap.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! Blend color into the pixels of image where the mask equals value, 8 mask bytes at a time.
+/*!
+An opacity of 255 writes the color unchanged.
+\returns false if the mask and image are not the same size.
+*/
+bool drawMaskBlend(tp_image_utils::ColorMap& image,
+                   TPPixel color,
+                   const tp_image_utils::ByteMap& mask,
+                   uint8_t value,
+                   uint8_t opacity);
+
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef tp_pipeline_image_utils_Expression_h
+#define tp_pipeline_image_utils_Expression_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include <memory>
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! A per pixel expression compiled to register bytecode, constant sub expressions are folded.
+/*!
+Supports numbers, variables, + - * / % < <= > >= == != && || ! ?: and the functions min, max,
+clamp, abs, sqrt and floor. Values are floats, division or modulus by 0 gives 0.
+*/
+class CompiledExpression
+{
+public:
+  //! The number of values evaluated per call to run().
+  static constexpr size_t lanes = 16;
+
+  //################################################################################################
+  ~CompiledExpression();
+
+  //################################################################################################
+  //! Compile an expression, compiled expressions are cached by their text.
+  /*!
+  \param error Set to a description of the problem if compilation fails.
+  \returns The compiled expression or nullptr on failure.
+  */
+  static std::shared_ptr<const CompiledExpression> compile(const std::string& expression, std::string& error);
+
+  //################################################################################################
+  //! The variables used by the expression, in the order that run() expects them.
+  const std::vector<std::string>& variables() const;
+
+  //################################################################################################
+  //! The number of floats of scratch space that run() needs.
+  size_t scratchSize() const;
+
+  //################################################################################################
+  //! Evaluate a block of lanes values.
+  /*!
+  \param inputs One array of lanes values for each of variables().
+  \param scratch At least scratchSize() floats, can be reused between calls.
+  \param result Receives lanes values.
+  */
+  void run(const float* const* inputs, float* scratch, float* result) const;
+
+private:
+  //################################################################################################
+  CompiledExpression();
+
+  struct Private;
+  friend struct Private;
+  Private* d;
+};
+
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef tp_pipeline_image_utils_ExtractGrid_h
+#define tp_pipeline_image_utils_ExtractGrid_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ColorMap.h"
+#include "tp_image_utils/Grid.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! Resample the cells of a grid into a width x height image, bands of cell rows run in parallel.
+/*!
+Bands are warped by ExtractRect::extractRect() and end on cell rows that map to whole output rows.
+*/
+tp_image_utils::ColorMap extractGrid(const tp_image_utils::ColorMap& src,
+                                     const tp_image_utils::Grid& grid,
+                                     size_t width,
+                                     size_t height,
+                                     std::vector<std::string>& errors);
+
+}
+
+#endif
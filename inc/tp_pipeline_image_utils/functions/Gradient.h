@@ -0,0 +1,56 @@
+#ifndef tp_pipeline_image_utils_Gradient_h
+#define tp_pipeline_image_utils_Gradient_h
+
+#include "tp_pipeline_image_utils/functions/Border.h"
+#include "tp_pipeline_image_utils/members/FloatMapMember.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! The image read by the gradient kernels, either color or gray with an optional virtual border.
+struct GradientSource
+{
+  const tp_image_utils::ColorMap* color{nullptr};
+  const tp_image_utils::ByteMap* byte{nullptr};
+  bool gray{false}; //!< Read color as its (r+g+b)/3 brightness, converted a row at a time.
+
+  size_t border{0};
+  BorderMode mode{BorderMode::Constant};
+  TPPixel fillColor{0, 0, 0};
+  uint8_t fillValue{0};
+
+  //################################################################################################
+  //! The width including the border.
+  size_t width() const;
+
+  //################################################################################################
+  //! The height including the border.
+  size_t height() const;
+};
+
+//##################################################################################################
+enum class GradientFeature
+{
+  Edge,  //!< Pixels where the gradient magnitude is above the threshold.
+  Corner //!< Pixels where the smaller eigenvalue of the 3x3 structure tensor is above the threshold.
+};
+
+//##################################################################################################
+//! Detect edges or corners with a 3x3 Sobel operator, output is 255 for detected pixels else 0.
+/*!
+The magnitude is the length of the gradients of all channels together divided by 4, corners compare
+the smaller eigenvalue of the 3x3 structure tensor in the same units. Row bands run in parallel.
+
+\param magnitude If not null receives the gradient magnitude of each pixel.
+\param orientation If not null receives atan2(gy, gx) of the strongest channel, y points down.
+*/
+tp_image_utils::ByteMap sobelDetect(const GradientSource& src,
+                                    GradientFeature feature,
+                                    size_t threshold,
+                                    FloatMap* magnitude=nullptr,
+                                    FloatMap* orientation=nullptr);
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef tp_pipeline_image_utils_HoughLines_h
+#define tp_pipeline_image_utils_HoughLines_h
+
+#include "tp_pipeline_image_utils/members/FloatMapMember.h"
+
+#include "tp_image_utils/ByteMap.h"
+
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+struct LineSegment
+{
+  float x0{0.0f};
+  float y0{0.0f};
+  float x1{0.0f};
+  float y1{0.0f};
+  size_t points{0}; //!< The number of pixels that support the segment.
+};
+
+//##################################################################################################
+struct HoughLineParameters
+{
+  size_t minPoints{30};    //!< Segments need at least this many pixels.
+  size_t maxDeviation{10}; //!< Pixels this far from the line belong to it, this is also the largest gap bridged.
+  size_t angleBins{180};   //!< The angular resolution of the accumulator over 180 degrees.
+
+  //! Optional gradient orientation per pixel in radians, see sobelDetect(). If set each pixel only
+  //! votes for angles within angleWindow of its gradient direction.
+  const FloatMap* orientation{nullptr};
+  float angleWindow{0.2f};
+};
+
+//##################################################################################################
+//! Find straight segments in the non zero pixels of a mask with a progressive probabilistic Hough transform.
+/*!
+Pixels vote in a fixed pseudo random order, each pixel is claimed by at most one segment.
+*/
+std::vector<LineSegment> houghLines(const tp_image_utils::ByteMap& src, const HoughLineParameters& params);
+
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef tp_pipeline_image_utils_JoinSegments_h
+#define tp_pipeline_image_utils_JoinSegments_h
+
+#include "tp_pipeline_image_utils/functions/HoughLines.h"
+
+#include <array>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+struct Polyline
+{
+  std::vector<std::array<float, 2>> points;
+  bool closed{false}; //!< If true the last point joins back to the first, it is not repeated.
+};
+
+//##################################################################################################
+//! Join segments end to end into polylines and closed polygons, closest ends first.
+/*!
+Ends are found through a grid with cells maxJointDistance wide, a joint is at the intersection of
+the two lines if that is near both ends, else at the mid point of the ends.
+*/
+std::vector<Polyline> joinSegments(const std::vector<LineSegment>& segments, float maxJointDistance);
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef tp_pipeline_image_utils_LocalStatistics_h
+#define tp_pipeline_image_utils_LocalStatistics_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+#include "tp_image_utils/ColorMap.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+enum class LocalStatistic
+{
+  Mean,    //!< Mean of the window, from an integral image.
+  Median,  //!< Median of the window, from a sliding histogram.
+  Mode,    //!< Most common value in the window, from a sliding histogram.
+  SoftMode //!< Mode of the window histogram after smoothing it with a small box filter.
+};
+
+//##################################################################################################
+//! The brightness of each pixel calculated as (r+g+b)/3.
+tp_image_utils::ByteMap brightness(const tp_image_utils::ColorMap& src);
+
+//##################################################################################################
+//! Calculate a statistic over the (2*radius+1)^2 window around each pixel.
+/*!
+Windows are clipped to the image. The cost per pixel is independent of the radius, the mean uses an
+integral image and the histogram statistics use Perreault's sliding column histograms. Rows are
+split into bands that are processed in parallel.
+*/
+tp_image_utils::ByteMap localStatistic(const tp_image_utils::ByteMap& src, size_t radius, LocalStatistic statistic);
+
+//##################################################################################################
+//! Normalize each pixel against the mean brightness of its neighbourhood.
+/*!
+If exaggeration is 0 the local mean is shifted to mid gray, else the difference from the local mean
+is multiplied by exaggeration.
+*/
+void normalizeBrightnessLocal(tp_image_utils::ColorMap& image, size_t radius, float exaggeration);
+
+//##################################################################################################
+//! Shift each pixel so that the statistic of its neighbourhood lands on target.
+void shiftBrightnessLocal(tp_image_utils::ColorMap& image, size_t radius, LocalStatistic statistic, uint8_t target);
+
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef tp_pipeline_image_utils_Palette_h
+#define tp_pipeline_image_utils_Palette_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+#include "tp_image_utils/ColorMap.h"
+
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! Quantize src to at most paletteSize colors, writing palette indices without an RGBA copy.
+/*!
+Median cut over a 16 level per channel RGBA histogram, each palette entry is the mean of its pixels.
+\returns false if paletteSize is 0 or more than 256.
+*/
+bool quantizeColors(const tp_image_utils::ColorMap& src,
+                    size_t paletteSize,
+                    tp_image_utils::ByteMap& indices,
+                    std::vector<TPPixel>& palette);
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef tp_pipeline_image_utils_PixelGrid_h
+#define tp_pipeline_image_utils_PixelGrid_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+#include "tp_image_utils/ColorMap.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! The cells of an upscaled pixel art image along one axis.
+struct PixelGridAxis
+{
+  double period{1.0}; //!< The width of a cell in image pixels, this need not be a whole number.
+  double start{0.0};  //!< Where the first cell starts, this is at most half a pixel into the image.
+  size_t cells{0};    //!< The number of cells needed to cover the image.
+};
+
+//##################################################################################################
+struct PixelGridEstimate
+{
+  PixelGridAxis x;
+  PixelGridAxis y;
+};
+
+//##################################################################################################
+//! Find the grid of an upscaled pixel art image from the FFT of its row and column edge profiles.
+/*!
+\param minPeriod The smallest cell size to consider, without a clear period cells are 1 pixel.
+*/
+PixelGridEstimate estimatePixelGrid(const tp_image_utils::ByteMap& src, size_t minPeriod=2);
+
+//##################################################################################################
+//! Make an image with one pixel per grid cell, the mean of the middle half of the cell.
+tp_image_utils::ByteMap samplePixelGrid(const tp_image_utils::ByteMap& src, const PixelGridEstimate& grid);
+
+//##################################################################################################
+tp_image_utils::ColorMap samplePixelGrid(const tp_image_utils::ColorMap& src, const PixelGridEstimate& grid);
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef tp_pipeline_image_utils_PixelManipulation_h
+#define tp_pipeline_image_utils_PixelManipulation_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+#include "tp_image_utils/ColorMap.h"
+
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! The expression for each output channel, see CompiledExpression for the syntax.
+/*!
+Variables are red, green, blue, alpha, byte, x and y, prefix them with an input alias as in
+"mask.byte". The byte of a color input is the mean of red, green and blue, results are rounded
+and clamped to 0 to 255.
+*/
+struct PixelExpressions
+{
+  std::string calcRed{"red"};
+  std::string calcGreen{"green"};
+  std::string calcBlue{"blue"};
+  std::string calcAlpha{"alpha"};
+  std::string calcByte{"byte"};
+};
+
+//##################################################################################################
+//! A named image that the expressions can read from, one of color or byte should be set.
+struct PixelInput
+{
+  std::string alias;
+  const tp_image_utils::ColorMap* color{nullptr};
+  const tp_image_utils::ByteMap* byte{nullptr};
+
+  //################################################################################################
+  PixelInput(const std::string& alias_, const tp_image_utils::ColorMap* color_):
+    alias(alias_),
+    color(color_)
+  {
+
+  }
+
+  //################################################################################################
+  PixelInput(const std::string& alias_, const tp_image_utils::ByteMap* byte_):
+    alias(alias_),
+    byte(byte_)
+  {
+
+  }
+};
+
+//##################################################################################################
+//! Evaluate the expressions for each pixel, the inputs must all be the same size.
+tp_image_utils::ColorMap compiledPixelManipulationColor(const std::vector<PixelInput>& inputs,
+                                                        const PixelExpressions& expressions,
+                                                        std::vector<std::string>& errors);
+
+//##################################################################################################
+tp_image_utils::ByteMap compiledPixelManipulationByte(const std::vector<PixelInput>& inputs,
+                                                      const PixelExpressions& expressions,
+                                                      std::vector<std::string>& errors);
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef tp_pipeline_image_utils_Rasterise_h
+#define tp_pipeline_image_utils_Rasterise_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ColorMap.h"
+#include "tp_image_utils/Grid.h"
+#include "tp_image_utils/Point.h"
+
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! Collects lines and then draws them all into an image in parallel bands of rows.
+/*!
+Lines are drawn in the order they were added, pixels within half the width of a line are covered.
+*/
+class LineBatch
+{
+public:
+  //################################################################################################
+  void addLine(float x0, float y0, float x1, float y1, TPPixel color, float width=1.0f);
+
+  //################################################################################################
+  //! Add each pair of consecutive points as a line.
+  void addLine(const tp_image_utils::Line& line, TPPixel color, float width=1.0f);
+
+  //################################################################################################
+  void addLines(const tp_image_utils::LineCollection& lines, TPPixel color, float width=1.0f);
+
+  //################################################################################################
+  //! Add the cell boundaries of a grid, infinite grids are extended to cover the image.
+  void addGrid(const tp_image_utils::Grid& grid, size_t imageWidth, size_t imageHeight, TPPixel color, float width=1.0f);
+
+  //################################################################################################
+  bool empty() const;
+
+  //################################################################################################
+  void draw(tp_image_utils::ColorMap& dst) const;
+
+private:
+  struct Line_lt
+  {
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+    TPPixel color;
+    float halfWidth;
+  };
+
+  std::vector<Line_lt> m_lines;
+};
+
+}
+
+#endif
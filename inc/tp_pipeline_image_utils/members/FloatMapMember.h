@@ -0,0 +1,45 @@
+#ifndef tp_pipeline_image_utils_FloatMapMember_h
+#define tp_pipeline_image_utils_FloatMapMember_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_data/AbstractMember.h"
+
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! A float per pixel, row major.
+struct FloatMap
+{
+  size_t width{0};
+  size_t height{0};
+  std::vector<float> values;
+
+  //################################################################################################
+  void setSize(size_t w, size_t h)
+  {
+    width = w;
+    height = h;
+    values.resize(w*h);
+  }
+};
+
+//##################################################################################################
+class FloatMapMember: public tp_data::AbstractMember
+{
+public:
+  //################################################################################################
+  FloatMapMember(const std::string& name=std::string());
+
+  //################################################################################################
+  void copyData(const tp_data::AbstractMember& other) override;
+
+  FloatMap data;
+};
+
+}
+
+#endif
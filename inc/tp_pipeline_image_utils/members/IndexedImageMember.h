@@ -0,0 +1,39 @@
+#ifndef tp_pipeline_image_utils_IndexedImageMember_h
+#define tp_pipeline_image_utils_IndexedImageMember_h
+
+#include "tp_pipeline_image_utils/Globals.h"
+
+#include "tp_image_utils/ByteMap.h"
+#include "tp_image_utils/ColorMap.h"
+
+#include "tp_data/AbstractMember.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! A palettised image, one byte index per pixel plus a palette of up to 256 colors.
+/*!
+Only the indices and palette are stored, the RGBA expansion is generated each time a consumer asks
+for it via colorMap() and is owned by the caller.
+*/
+class IndexedImageMember: public tp_data::AbstractMember
+{
+public:
+  //################################################################################################
+  IndexedImageMember(const std::string& name=std::string());
+
+  //################################################################################################
+  void copyData(const tp_data::AbstractMember& other) override;
+
+  //################################################################################################
+  //! Returns the image expanded through the palette, indices outside the palette become black.
+  tp_image_utils::ColorMap colorMap() const;
+
+  tp_image_utils::ByteMap indices;
+  std::vector<TPPixel> palette;
+};
+
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef tp_pipeline_image_utils_LabelMapMember_h
+#define tp_pipeline_image_utils_LabelMapMember_h
+
+#include "tp_pipeline_image_utils/functions/CellSegment.h"
+
+#include "tp_data/AbstractMember.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! A map of 32 bit labels, used where a byte map would limit the number of labels to 255.
+class LabelMapMember: public tp_data::AbstractMember
+{
+public:
+  //################################################################################################
+  LabelMapMember(const std::string& name=std::string());
+
+  //################################################################################################
+  void copyData(const tp_data::AbstractMember& other) override;
+
+  LabelMap data;
+};
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef tp_pipeline_image_utils_PaddedImageMember_h
+#define tp_pipeline_image_utils_PaddedImageMember_h
+
+#include "tp_pipeline_image_utils/functions/Border.h"
+
+#include "tp_data/AbstractMember.h"
+
+#include <memory>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+//! An image with a virtual border, the unpadded source is shared and the border is computed.
+/*!
+Kernels that understand this member read the source and map out of range coordinates through
+borderCoordinate(). Anything else gets a padded copy from colorMap() or byteMap().
+*/
+class PaddedImageMember: public tp_data::AbstractMember
+{
+public:
+  //################################################################################################
+  PaddedImageMember(const std::string& name=std::string());
+
+  //################################################################################################
+  ~PaddedImageMember() override;
+
+  //################################################################################################
+  //! Copies share the source.
+  void copyData(const tp_data::AbstractMember& other) override;
+
+  //################################################################################################
+  void setSource(const std::shared_ptr<const tp_image_utils::ColorMap>& source, size_t border, BorderMode mode, TPPixel color);
+
+  //################################################################################################
+  void setSource(const std::shared_ptr<const tp_image_utils::ByteMap>& source, size_t border, BorderMode mode, uint8_t value);
+
+  //################################################################################################
+  //! The source color image or nullptr if this pads a byte map.
+  const tp_image_utils::ColorMap* colorSource() const;
+
+  //################################################################################################
+  //! The source byte map or nullptr if this pads a color image.
+  const tp_image_utils::ByteMap* byteSource() const;
+
+  //################################################################################################
+  size_t border() const;
+
+  //################################################################################################
+  BorderMode mode() const;
+
+  //################################################################################################
+  //! The fill color for Constant mode on color images.
+  TPPixel color() const;
+
+  //################################################################################################
+  //! The fill value for Constant mode on byte maps.
+  uint8_t value() const;
+
+  //################################################################################################
+  //! The padded width.
+  size_t width() const;
+
+  //################################################################################################
+  //! The padded height.
+  size_t height() const;
+
+  //################################################################################################
+  //! Returns a padded copy of the color image, empty if colorSource() is not set.
+  tp_image_utils::ColorMap colorMap() const;
+
+  //################################################################################################
+  //! Returns a padded copy of the byte map, empty if byteSource() is not set.
+  tp_image_utils::ByteMap byteMap() const;
+
+private:
+  struct Private;
+  friend struct Private;
+  Private* d;
+};
+
+}
+
+#endif
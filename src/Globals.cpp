@@ -138,6 +138,10 @@ TDP_DEFINE_ID(                    calcAlphaSID,                       "Calc alph
 TDP_DEFINE_ID(                     calcByteSID,                        "Calc byte")
 TDP_DEFINE_ID(                            xSID,                                "X")
 TDP_DEFINE_ID(                            ySID,                                "Y")
+TDP_DEFINE_ID(                 outputFormatSID,                    "Output format")
+TDP_DEFINE_ID(                       engineSID,                           "Engine")
+TDP_DEFINE_ID(                  namedInputsSID,                     "Named inputs")
+TDP_DEFINE_ID(                   borderModeSID,                      "Border mode")
 
 //##################################################################################################
 void createStepDelegates(tp_pipeline::StepDelegateMap& stepDelegates, const tp_data::CollectionFactory* collectionFactory)
@@ -214,6 +218,23 @@ TPPixel makeColor(size_t index)
   return lookup[index%256];
 }
 
+//##################################################################################################
+TPPixel makeLabelColor(uint32_t label)
+{
+  if(label<256)
+    return makeColor(label);
+
+  // Mix the bits so that neighbouring labels get unrelated colors.
+  uint32_t h = label;
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+
+  return TPPixel(uint8_t(h), uint8_t(h>>8), uint8_t(h>>16), 255);
+}
+
 //##################################################################################################
 void validateColor(tp_pipeline::Parameter& param, const TPPixel& color)
 {
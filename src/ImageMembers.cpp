@@ -0,0 +1,69 @@
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/members/IndexedImageMember.h"
+#include "tp_pipeline_image_utils/members/PaddedImageMember.h"
+
+#include "tp_data_image_utils/members/ColorMapMember.h"
+#include "tp_data_image_utils/members/ByteMapMember.h"
+
+#include "tp_pipeline/StepInput.h"
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+//##################################################################################################
+//! Wrap an image that is owned by a member, the pointer does not take ownership.
+template<typename T>
+std::shared_ptr<const T> borrowed(const T& image)
+{
+  return std::shared_ptr<const T>(std::shared_ptr<const T>(), &image);
+}
+}
+
+//##################################################################################################
+std::shared_ptr<const tp_image_utils::ColorMap> colorMapFromMember(const tp_data::AbstractMember* member)
+{
+  if(auto color = dynamic_cast<const tp_data_image_utils::ColorMapMember*>(member); color)
+    return borrowed(color->data);
+
+  if(auto indexed = dynamic_cast<const IndexedImageMember*>(member); indexed)
+    return std::make_shared<const tp_image_utils::ColorMap>(indexed->colorMap());
+
+  if(auto padded = dynamic_cast<const PaddedImageMember*>(member); padded && padded->colorSource())
+    return std::make_shared<const tp_image_utils::ColorMap>(padded->colorMap());
+
+  return nullptr;
+}
+
+//##################################################################################################
+std::shared_ptr<const tp_image_utils::ColorMap> findColorMap(const tp_pipeline::StepInput& input, const std::string& name)
+{
+  if(name.empty())
+    return nullptr;
+
+  return colorMapFromMember(input.member(name));
+}
+
+//##################################################################################################
+std::shared_ptr<const tp_image_utils::ByteMap> byteMapFromMember(const tp_data::AbstractMember* member)
+{
+  if(auto byte = dynamic_cast<const tp_data_image_utils::ByteMapMember*>(member); byte)
+    return borrowed(byte->data);
+
+  if(auto padded = dynamic_cast<const PaddedImageMember*>(member); padded && padded->byteSource())
+    return std::make_shared<const tp_image_utils::ByteMap>(padded->byteMap());
+
+  return nullptr;
+}
+
+//##################################################################################################
+std::shared_ptr<const tp_image_utils::ByteMap> findByteMap(const tp_pipeline::StepInput& input, const std::string& name)
+{
+  if(name.empty())
+    return nullptr;
+
+  return byteMapFromMember(input.member(name));
+}
+
+}
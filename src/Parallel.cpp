@@ -0,0 +1,203 @@
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+//##################################################################################################
+//! Set while a thread runs ranges of a job so that nested calls to parallelFor run serially.
+thread_local bool inJob_lt{false};
+
+//##################################################################################################
+struct Job_lt
+{
+  const std::function<void(size_t begin, size_t end, size_t range)>* closure{nullptr};
+  size_t count{0};
+  size_t ranges{0};
+  size_t rangeSize{0};
+
+  std::atomic<size_t> next{0};
+  std::atomic<bool> failed{false};
+
+  std::mutex mutex;
+  std::condition_variable finished;
+  size_t done{0};
+  std::exception_ptr error;
+
+  //################################################################################################
+  //! Claim and run ranges until there are none left, returns once this thread has nothing to do.
+  void work()
+  {
+    for(size_t r=next++; r<ranges; r=next++)
+    {
+      if(!failed)
+      {
+        try
+        {
+          size_t begin = r*rangeSize;
+          (*closure)(begin, tpMin(count, begin+rangeSize), r);
+        }
+        catch(...)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if(!error)
+            error = std::current_exception();
+          failed = true;
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      done++;
+      if(done==ranges)
+        finished.notify_all();
+    }
+  }
+};
+
+//##################################################################################################
+//! Threads that live for the life of the process and take ranges from queued jobs.
+class ThreadPool_lt
+{
+public:
+  //################################################################################################
+  ThreadPool_lt(size_t threads)
+  {
+    m_threads.reserve(threads);
+    for(size_t i=0; i<threads; i++)
+      m_threads.emplace_back([this]{run();});
+  }
+
+  //################################################################################################
+  ~ThreadPool_lt()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for(auto& thread : m_threads)
+      thread.join();
+  }
+
+  //################################################################################################
+  //! Queue the job, help with it on the calling thread and wait for the pool to finish it.
+  void execute(const std::shared_ptr<Job_lt>& job)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_jobs.push_back(job);
+    }
+    m_wake.notify_all();
+
+    inJob_lt = true;
+    job->work();
+    inJob_lt = false;
+
+    {
+      std::unique_lock<std::mutex> lock(job->mutex);
+      job->finished.wait(lock, [&]{return job->done==job->ranges;});
+    }
+
+    remove(job);
+  }
+
+private:
+  //################################################################################################
+  void run()
+  {
+    inJob_lt = true;
+
+    for(;;)
+    {
+      std::shared_ptr<Job_lt> job;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [&]{return m_stop || !m_jobs.empty();});
+        if(m_stop)
+          return;
+        job = m_jobs.front();
+      }
+
+      job->work();
+      remove(job);
+    }
+  }
+
+  //################################################################################################
+  //! Jobs leave the queue once every range has been claimed.
+  void remove(const std::shared_ptr<Job_lt>& job)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(auto i=m_jobs.begin(); i!=m_jobs.end(); ++i)
+    {
+      if(*i==job)
+      {
+        m_jobs.erase(i);
+        break;
+      }
+    }
+  }
+
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::deque<std::shared_ptr<Job_lt>> m_jobs;
+  bool m_stop{false};
+};
+
+//##################################################################################################
+ThreadPool_lt& threadPool()
+{
+  // The calling thread always works on its own job, so the pool needs one thread less.
+  static ThreadPool_lt pool(threadCount()-1);
+  return pool;
+}
+}
+
+//##################################################################################################
+size_t threadCount()
+{
+  static const size_t count = tpMax(size_t(1), size_t(std::thread::hardware_concurrency()));
+  return count;
+}
+
+//##################################################################################################
+void parallelFor(size_t count,
+                 size_t minRange,
+                 const std::function<void(size_t begin, size_t end, size_t range)>& closure)
+{
+  if(count<1)
+    return;
+
+  size_t ranges = tpBound(size_t(1), count / tpMax(size_t(1), minRange), threadCount());
+
+  if(ranges==1 || inJob_lt)
+  {
+    closure(0, count, 0);
+    return;
+  }
+
+  auto job = std::make_shared<Job_lt>();
+  job->closure = &closure;
+  job->count = count;
+  job->rangeSize = (count+ranges-1) / ranges;
+  job->ranges = (count+job->rangeSize-1) / job->rangeSize;
+
+  threadPool().execute(job);
+
+  if(job->error)
+    std::rethrow_exception(job->error);
+}
+
+}
@@ -0,0 +1,108 @@
+#include "tp_pipeline_image_utils/functions/Bitwise.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <cstring>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+//##################################################################################################
+//! Evaluate the truth table on every bit of p and q at once.
+template<typename T>
+T apply(T p, T q, T m00, T m01, T m10, T m11)
+{
+  return (~p & ~q & m00) | (~p & q & m01) | (p & ~q & m10) | (p & q & m11);
+}
+
+//##################################################################################################
+template<typename T>
+T mask(TruthTable table, int bit)
+{
+  return ((table>>bit)&1)?T(~T(0)):T(0);
+}
+}
+
+//##################################################################################################
+bool truthTable(tp_image_utils_functions::LogicOp operation, TruthTable& table)
+{
+  // In the low nibble of the first pair bit (p<<1 | q) holds p and q, so the result is the table.
+  // The other pairs check that every bit is treated the same way.
+  const uint8_t pairs[][2] = {{0xCC, 0xAA}, {0x33, 0x55}, {0x00, 0xFF}, {0xF0, 0x3C}};
+  constexpr size_t count = sizeof(pairs)/sizeof(pairs[0]);
+
+  tp_image_utils::ByteMap p;
+  tp_image_utils::ByteMap q;
+  p.setSize(count, 1);
+  q.setSize(count, 1);
+  for(size_t i=0; i<count; i++)
+  {
+    p.data()[i] = pairs[i][0];
+    q.data()[i] = pairs[i][1];
+  }
+
+  tp_image_utils::ByteMap result = tp_image_utils_functions::bitwise(p, q, operation);
+  if(result.size()!=count)
+    return false;
+
+  table = result.constData()[0] & 0x0F;
+  const auto m00 = mask<uint8_t>(table, 0);
+  const auto m01 = mask<uint8_t>(table, 1);
+  const auto m10 = mask<uint8_t>(table, 2);
+  const auto m11 = mask<uint8_t>(table, 3);
+  for(size_t i=0; i<count; i++)
+    if(result.constData()[i] != apply<uint8_t>(pairs[i][0], pairs[i][1], m00, m01, m10, m11))
+      return false;
+
+  return true;
+}
+
+//##################################################################################################
+void bitwiseInPlace(tp_image_utils::ByteMap& dst,
+                    const std::vector<const tp_image_utils::ByteMap*>& operands,
+                    TruthTable table)
+{
+  if(operands.empty())
+    return;
+
+  const auto m00 = mask<uint64_t>(table, 0);
+  const auto m01 = mask<uint64_t>(table, 1);
+  const auto m10 = mask<uint64_t>(table, 2);
+  const auto m11 = mask<uint64_t>(table, 3);
+
+  size_t size = dst.size();
+  size_t words = size/8;
+  uint8_t* d = dst.data();
+
+  std::vector<const uint8_t*> q;
+  q.reserve(operands.size());
+  for(const auto operand : operands)
+    q.push_back(operand->constData());
+
+  parallelFor(words, 16384, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t w=begin; w<end; w++)
+    {
+      uint64_t acc;
+      std::memcpy(&acc, d+w*8, 8);
+      for(const uint8_t* o : q)
+      {
+        uint64_t v;
+        std::memcpy(&v, o+w*8, 8);
+        acc = apply(acc, v, m00, m01, m10, m11);
+      }
+      std::memcpy(d+w*8, &acc, 8);
+    }
+  });
+
+  for(size_t i=words*8; i<size; i++)
+  {
+    uint8_t acc = d[i];
+    for(const uint8_t* o : q)
+      acc = apply<uint8_t>(acc, o[i], uint8_t(m00), uint8_t(m01), uint8_t(m10), uint8_t(m11));
+    d[i] = acc;
+  }
+}
+
+}
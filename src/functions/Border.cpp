@@ -0,0 +1,89 @@
+#include "tp_pipeline_image_utils/functions/Border.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <cstring>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+//##################################################################################################
+template<typename Image, typename T>
+Image pad(const Image& src, size_t border, BorderMode mode, T value)
+{
+  size_t sw = src.width();
+  size_t sh = src.height();
+  size_t dw = sw + border*2;
+  size_t dh = sh + border*2;
+
+  Image dst;
+  dst.setSize(dw, dh);
+  if(dw<1 || dh<1)
+    return dst;
+
+  const T* s = src.constData();
+  T* d = dst.data();
+
+  parallelFor(dh, 16, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t y=begin; y<end; y++)
+    {
+      T* out = d + y*dw;
+      int64_t sy = (sw && sh)?borderCoordinate(int64_t(y)-int64_t(border), sh, mode):-1;
+      if(sy<0)
+      {
+        std::fill(out, out+dw, value);
+        continue;
+      }
+
+      const T* in = s + size_t(sy)*sw;
+      for(size_t x=0; x<border; x++)
+      {
+        int64_t sx = borderCoordinate(int64_t(x)-int64_t(border), sw, mode);
+        out[x] = (sx<0)?value:in[sx];
+      }
+
+      std::memcpy(out+border, in, sw*sizeof(T));
+
+      for(size_t x=border+sw; x<dw; x++)
+      {
+        int64_t sx = borderCoordinate(int64_t(x)-int64_t(border), sw, mode);
+        out[x] = (sx<0)?value:in[sx];
+      }
+    }
+  });
+
+  return dst;
+}
+}
+
+//##################################################################################################
+std::vector<std::string> borderModes()
+{
+  return {"Constant", "Clamp", "Reflect"};
+}
+
+//##################################################################################################
+BorderMode borderModeFromString(const std::string& mode)
+{
+  if(mode == "Clamp")
+    return BorderMode::Clamp;
+  if(mode == "Reflect")
+    return BorderMode::Reflect;
+  return BorderMode::Constant;
+}
+
+//##################################################################################################
+tp_image_utils::ColorMap padColorMap(const tp_image_utils::ColorMap& src, size_t border, BorderMode mode, TPPixel color)
+{
+  return pad(src, border, mode, color);
+}
+
+//##################################################################################################
+tp_image_utils::ByteMap padByteMap(const tp_image_utils::ByteMap& src, size_t border, BorderMode mode, uint8_t value)
+{
+  return pad(src, border, mode, value);
+}
+
+}
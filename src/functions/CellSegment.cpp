@@ -0,0 +1,442 @@
+#include "tp_pipeline_image_utils/functions/CellSegment.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <algorithm>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+//##################################################################################################
+struct Seed_lt
+{
+  size_t index;
+  uint32_t distance;
+};
+
+//##################################################################################################
+//! Two pass 3-4 chamfer distance to the nearest background pixel, in units of 1/3 pixel.
+std::vector<uint32_t> distanceField(const tp_image_utils::ByteMap& src, size_t radius)
+{
+  size_t w = src.width();
+  size_t h = src.height();
+  uint32_t maxDistance = uint32_t(radius*3);
+
+  std::vector<uint32_t> d(w*h);
+  const uint8_t* s = src.constData();
+  for(size_t i=0; i<w*h; i++)
+    d[i] = s[i]?maxDistance:0;
+
+  auto relax = [&](size_t i, int64_t x, int64_t y, uint32_t cost)
+  {
+    if(x<0 || y<0 || x>=int64_t(w) || y>=int64_t(h))
+    {
+      d[i] = tpMin(d[i], cost);
+      return;
+    }
+    d[i] = tpMin(d[i], d[size_t(y)*w+size_t(x)]+cost);
+  };
+
+  for(int64_t y=0; y<int64_t(h); y++)
+  {
+    for(int64_t x=0; x<int64_t(w); x++)
+    {
+      size_t i = size_t(y)*w+size_t(x);
+      if(!d[i])
+        continue;
+      relax(i, x-1, y  , 3);
+      relax(i, x-1, y-1, 4);
+      relax(i, x  , y-1, 3);
+      relax(i, x+1, y-1, 4);
+    }
+  }
+
+  for(int64_t y=int64_t(h)-1; y>=0; y--)
+  {
+    for(int64_t x=int64_t(w)-1; x>=0; x--)
+    {
+      size_t i = size_t(y)*w+size_t(x);
+      if(!d[i])
+        continue;
+      relax(i, x+1, y  , 3);
+      relax(i, x+1, y+1, 4);
+      relax(i, x  , y+1, 3);
+      relax(i, x-1, y+1, 4);
+    }
+  }
+
+  return d;
+}
+
+//##################################################################################################
+//! Local maxima of the distance field that are at least minRadius from the background.
+std::vector<Seed_lt> findSeeds(const std::vector<uint32_t>& distance, size_t w, size_t h, size_t yBegin, size_t yEnd, size_t minRadius)
+{
+  std::vector<Seed_lt> seeds;
+  uint32_t minDistance = uint32_t(minRadius*3);
+
+  for(size_t y=yBegin; y<yEnd; y++)
+  {
+    for(size_t x=0; x<w; x++)
+    {
+      size_t i = y*w+x;
+      uint32_t v = distance[i];
+      if(v<minDistance || v==0)
+        continue;
+
+      bool isMax=true;
+      for(int dy=-1; dy<=1 && isMax; dy++)
+      {
+        for(int dx=-1; dx<=1; dx++)
+        {
+          int64_t nx = int64_t(x)+dx;
+          int64_t ny = int64_t(y)+dy;
+          if((dx==0 && dy==0) || nx<0 || ny<0 || nx>=int64_t(w) || ny>=int64_t(h))
+            continue;
+
+          if(distance[size_t(ny)*w+size_t(nx)]>v)
+          {
+            isMax=false;
+            break;
+          }
+        }
+      }
+
+      if(isMax)
+        seeds.push_back({i, v});
+    }
+  }
+
+  return seeds;
+}
+
+//##################################################################################################
+//! Keep the largest seeds that are not inside an already accepted seed.
+std::vector<Seed_lt> selectSeeds(std::vector<Seed_lt> candidates, size_t w, size_t h, size_t maxSeeds)
+{
+  std::stable_sort(candidates.begin(), candidates.end(), [](const Seed_lt& a, const Seed_lt& b)
+  {
+    return a.distance>b.distance;
+  });
+
+  std::vector<Seed_lt> seeds;
+  if(candidates.empty() || maxSeeds==0)
+    return seeds;
+
+  // Candidates are sorted by radius so no accepted seed is larger than the first. With cells of
+  // that size a seed can only contain candidates that are in its own or a neighbouring cell.
+  int64_t cellSize = tpMax(int64_t(1), int64_t(candidates.front().distance/3));
+  int64_t gw = int64_t(w)/cellSize + 1;
+  int64_t gh = int64_t(h)/cellSize + 1;
+  std::vector<std::vector<size_t>> grid(size_t(gw*gh));
+
+  for(const auto& candidate : candidates)
+  {
+    if(seeds.size()>=maxSeeds)
+      break;
+
+    int64_t cx = int64_t(candidate.index%w);
+    int64_t cy = int64_t(candidate.index/w);
+    int64_t gx = cx/cellSize;
+    int64_t gy = cy/cellSize;
+
+    bool inside=false;
+    for(int64_t ny=tpMax(int64_t(0), gy-1); ny<=tpMin(gh-1, gy+1) && !inside; ny++)
+    {
+      for(int64_t nx=tpMax(int64_t(0), gx-1); nx<=tpMin(gw-1, gx+1) && !inside; nx++)
+      {
+        for(size_t s : grid[size_t(ny*gw+nx)])
+        {
+          const auto& seed = seeds[s];
+          int64_t dx = int64_t(seed.index%w) - cx;
+          int64_t dy = int64_t(seed.index/w) - cy;
+          int64_t r = int64_t(seed.distance/3);
+          if(dx*dx + dy*dy <= r*r)
+          {
+            inside=true;
+            break;
+          }
+        }
+      }
+    }
+
+    if(!inside)
+    {
+      grid[size_t(gy*gw+gx)].push_back(seeds.size());
+      seeds.push_back(candidate);
+    }
+  }
+
+  return seeds;
+}
+
+//##################################################################################################
+//! Paint each seed as a disc of foreground pixels, earlier seeds win.
+void paintSeeds(const std::vector<Seed_lt>& seeds, const uint8_t* fg, size_t w, size_t h, std::vector<uint32_t>& labels)
+{
+  for(size_t s=0; s<seeds.size(); s++)
+  {
+    const auto& seed = seeds.at(s);
+    auto label = uint32_t(s+1);
+    int64_t cx = int64_t(seed.index%w);
+    int64_t cy = int64_t(seed.index/w);
+    int64_t r = int64_t(seed.distance/3);
+
+    for(int64_t y=tpMax(int64_t(0), cy-r); y<=tpMin(int64_t(h)-1, cy+r); y++)
+    {
+      for(int64_t x=tpMax(int64_t(0), cx-r); x<=tpMin(int64_t(w)-1, cx+r); x++)
+      {
+        int64_t dx=x-cx;
+        int64_t dy=y-cy;
+        size_t i = size_t(y)*w+size_t(x);
+        if(dx*dx+dy*dy<=r*r && fg[i] && !labels[i])
+          labels[i] = label;
+      }
+    }
+  }
+}
+
+//##################################################################################################
+//! Find seeds in row bands on all threads, the bands are concatenated in order.
+std::vector<Seed_lt> findSeedsParallel(const std::vector<uint32_t>& distance, size_t w, size_t h, size_t minRadius)
+{
+  std::vector<std::vector<Seed_lt>> bands(threadCount());
+  parallelFor(h, 64, [&](size_t yBegin, size_t yEnd, size_t range)
+  {
+    bands[range] = findSeeds(distance, w, h, yBegin, yEnd, minRadius);
+  });
+
+  std::vector<Seed_lt> seeds;
+  for(const auto& band : bands)
+    seeds.insert(seeds.end(), band.begin(), band.end());
+  return seeds;
+}
+
+//##################################################################################################
+struct Candidate_lt
+{
+  size_t index;
+  uint32_t label;
+};
+
+//##################################################################################################
+//! The rows owned by one thread during growth.
+struct GrowBand_lt
+{
+  size_t yBegin{0};
+  size_t yEnd{0};
+  std::vector<size_t> frontier;        //!< Owned pixels labelled in the last pass of the batch.
+  std::vector<size_t> nextFrontier;
+  std::vector<Candidate_lt> changes;   //!< Owned pixels labelled during the batch.
+
+  //-- Working copy of the band and its halo --------------------------------------------------------
+  std::vector<uint32_t> labels;
+  std::vector<uint32_t> pass;          //!< The pass in the batch that labelled each pixel, 0 if before.
+  std::vector<size_t> current;
+  std::vector<size_t> next;
+};
+
+//##################################################################################################
+/*!
+Growth moves at most one row per pass, so after k passes the rows of a band only depend on the band
+and the k rows either side of it. Each band copies that window and runs a batch of k passes on it
+serially, then the labels of the rows it owns are written back. Nothing is written to the shared
+labels while the windows are being grown and each pixel has one writer afterwards, so there are two
+parallel regions per batch rather than per pass. Within a pass the lowest label wins no matter what
+order the frontier is visited in, so the result matches the serial scan.
+*/
+void growCells(const uint8_t* fg, size_t w, size_t h, const FrontierCellSegmentParameters& params, std::vector<uint32_t>& labels)
+{
+  static const int box[8][2]   = {{-1,-1},{0,-1},{1,-1},{-1,0},{1,0},{-1,1},{0,1},{1,1}};
+  static const int flood[4][2] = {{0,-1},{-1,0},{1,0},{0,1}};
+
+  const int (*offsets)[2] = (params.growth==CellGrowth::Box)?box:flood;
+  size_t nOffsets         = (params.growth==CellGrowth::Box)?8:4;
+
+  size_t nThreads = threadCount();
+  size_t bandHeight = (h+nThreads-1) / nThreads;
+  size_t nBands = (h+bandHeight-1) / bandHeight;
+
+  // With one band there is no halo so all passes run as one batch, otherwise the halo is kept
+  // smaller than the band.
+  size_t batchSize = (nBands==1)?params.growCellsPasses:tpBound(size_t(1), bandHeight/2, size_t(64));
+
+  std::vector<GrowBand_lt> bands(nBands);
+  parallelFor(nBands, 1, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t b=begin; b<end; b++)
+    {
+      auto& band = bands[b];
+      band.yBegin = b*bandHeight;
+      band.yEnd = tpMin(h, band.yBegin+bandHeight);
+      for(size_t i=band.yBegin*w; i<band.yEnd*w; i++)
+        if(labels[i])
+          band.frontier.push_back(i);
+    }
+  });
+
+  auto growing = [&]
+  {
+    for(const auto& band : bands)
+      if(!band.frontier.empty())
+        return true;
+    return false;
+  };
+
+  for(size_t p=0; p<params.growCellsPasses && growing(); p+=batchSize)
+  {
+    auto k = uint32_t(tpMin(batchSize, params.growCellsPasses-p));
+
+    //-- Grow each window, reading the shared labels only -------------------------------------------
+    parallelFor(nBands, 1, [&](size_t begin, size_t end, size_t)
+    {
+      for(size_t b=begin; b<end; b++)
+      {
+        auto& band = bands[b];
+        band.changes.clear();
+        band.nextFrontier.clear();
+
+        size_t wBegin = (band.yBegin>k)?(band.yBegin-k):0;
+        size_t wEnd = tpMin(h, band.yEnd+k);
+        size_t wh = wEnd-wBegin;
+
+        band.current.clear();
+        for(size_t o=wBegin/bandHeight; o<=(wEnd-1)/bandHeight; o++)
+        {
+          for(size_t i : bands[o].frontier)
+          {
+            size_t y = i/w;
+            if(y>=wBegin && y<wEnd)
+              band.current.push_back(i - wBegin*w);
+          }
+        }
+
+        if(band.current.empty())
+          continue;
+
+        const uint8_t* wfg = fg + wBegin*w;
+        band.labels.assign(labels.data() + wBegin*w, labels.data() + wEnd*w);
+        band.pass.assign(wh*w, 0);
+        uint32_t* l = band.labels.data();
+        uint32_t* ps = band.pass.data();
+
+        for(uint32_t j=1; j<=k && !band.current.empty(); j++)
+        {
+          band.next.clear();
+          for(size_t i : band.current)
+          {
+            int64_t x = int64_t(i%w);
+            int64_t y = int64_t(i/w);
+            uint32_t label = l[i];
+
+            for(size_t o=0; o<nOffsets; o++)
+            {
+              int64_t nx = x+offsets[o][0];
+              int64_t ny = y+offsets[o][1];
+              if(nx<0 || ny<0 || nx>=int64_t(w) || ny>=int64_t(wh))
+                continue;
+
+              size_t n = size_t(ny)*w+size_t(nx);
+              if(!wfg[n])
+                continue;
+
+              if(!l[n])
+              {
+                l[n] = label;
+                ps[n] = j;
+                band.next.push_back(n);
+              }
+              else if(ps[n]==j && label<l[n])
+                l[n] = label;
+            }
+          }
+          std::swap(band.current, band.next);
+        }
+
+        size_t iEnd = (band.yEnd-wBegin)*w;
+        for(size_t i=(band.yBegin-wBegin)*w; i<iEnd; i++)
+        {
+          if(!ps[i])
+            continue;
+
+          size_t n = i + wBegin*w;
+          band.changes.push_back({n, l[i]});
+          if(ps[i]==k)
+            band.nextFrontier.push_back(n);
+        }
+      }
+    });
+
+    //-- Write back the rows that each band owns ----------------------------------------------------
+    parallelFor(nBands, 1, [&](size_t begin, size_t end, size_t)
+    {
+      for(size_t b=begin; b<end; b++)
+      {
+        auto& band = bands[b];
+        for(const auto& change : band.changes)
+          labels[change.index] = change.label;
+        std::swap(band.frontier, band.nextFrontier);
+      }
+    });
+  }
+}
+}
+
+//##################################################################################################
+LabelMap toLabelMap(const tp_image_utils::ByteMap& src)
+{
+  LabelMap dst;
+  dst.width  = src.width();
+  dst.height = src.height();
+  dst.labels.assign(src.constData(), src.constData()+src.size());
+  return dst;
+}
+
+//##################################################################################################
+tp_image_utils::ByteMap toByteMap(const LabelMap& src)
+{
+  tp_image_utils::ByteMap dst;
+  dst.setSize(src.width, src.height);
+  uint8_t* d = dst.data();
+  for(size_t i=0; i<src.labels.size(); i++)
+    d[i] = uint8_t(tpMin(src.labels[i], uint32_t(255)));
+  return dst;
+}
+
+//##################################################################################################
+LabelMap frontierCellSegment(const tp_image_utils::ByteMap& src,
+                             const LabelMap* labels,
+                             const FrontierCellSegmentParameters& params)
+{
+  LabelMap result;
+  result.width  = src.width();
+  result.height = src.height();
+  result.labels.resize(src.size(), 0);
+
+  size_t w = result.width;
+  size_t h = result.height;
+  if(w<1 || h<1)
+    return result;
+
+  const uint8_t* fg = src.constData();
+
+  if(labels && labels->width==w && labels->height==h)
+  {
+    const uint32_t* l = labels->labels.data();
+    for(size_t i=0; i<w*h; i++)
+      if(fg[i])
+        result.labels[i] = l[i];
+  }
+  else
+  {
+    std::vector<uint32_t> distance = distanceField(src, params.distanceFieldRadius);
+    std::vector<Seed_lt> seeds = selectSeeds(findSeedsParallel(distance, w, h, params.minRadius), w, h, params.maxInitialCells);
+    paintSeeds(seeds, fg, w, h, result.labels);
+  }
+
+  growCells(fg, w, h, params, result.labels);
+  return result;
+}
+
+}
@@ -0,0 +1,431 @@
+#include "tp_pipeline_image_utils/functions/Contours.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+using Vertex = std::array<float, 2>;
+using Contour = std::vector<Vertex>;
+
+//##################################################################################################
+struct Segment_lt
+{
+  uint64_t from;
+  uint64_t to;
+  uint32_t pixel; //!< A pixel on the inside of the segment.
+  uint8_t label;
+  uint8_t side;   //!< Which of the 2 pixels either side of the from vertex is inside.
+};
+
+//##################################################################################################
+//! Vertices are identified by the pixel edge they sit on.
+/*!
+Pixel coordinates are offset by 1 so that the padding row and column of cells at -1 are valid.
+Vertex type 0 sits between (x,y) and (x+1,y), type 1 between (x,y) and (x,y+1).
+*/
+struct VertexIds_lt
+{
+  size_t stride;
+
+  //################################################################################################
+  uint64_t id(int64_t x, int64_t y, uint64_t type) const
+  {
+    return ((uint64_t(y+1)*stride + uint64_t(x+1))<<1) | type;
+  }
+
+  //################################################################################################
+  Vertex position(uint64_t id) const
+  {
+    uint64_t type = id&1;
+    uint64_t i = id>>1;
+    auto x = float(int64_t(i%stride)-1);
+    auto y = float(int64_t(i/stride)-1);
+    return type?Vertex{x+0.5f, y+1.0f}:Vertex{x+1.0f, y+0.5f};
+  }
+
+  //################################################################################################
+  //! The first of the 2 pixels either side of a vertex, the second is at +x or +y.
+  void firstPixel(uint64_t id, int64_t& x, int64_t& y) const
+  {
+    uint64_t i = id>>1;
+    x = int64_t(i%stride)-1;
+    y = int64_t(i/stride)-1;
+  }
+};
+
+//##################################################################################################
+bool collinear(const Vertex& a, const Vertex& b, const Vertex& c)
+{
+  return (b[0]-a[0])*(c[1]-b[1]) == (b[1]-a[1])*(c[0]-b[0]);
+}
+
+//##################################################################################################
+double signedArea(const Contour& contour)
+{
+  double area=0.0;
+  for(size_t i=0, j=contour.size()-1; i<contour.size(); j=i++)
+    area += double(contour[j][0])*double(contour[i][1]) - double(contour[i][0])*double(contour[j][1]);
+  return area*0.5;
+}
+
+//##################################################################################################
+void douglasPeucker(const Contour& contour, size_t first, size_t last, double tolerance, std::vector<bool>& keep)
+{
+  if(last<=first+1)
+    return;
+
+  double ax = double(contour[first][0]);
+  double ay = double(contour[first][1]);
+  double dx = double(contour[last][0])-ax;
+  double dy = double(contour[last][1])-ay;
+  double length = std::sqrt(dx*dx + dy*dy);
+
+  size_t worst=first;
+  double worstDistance=0.0;
+  for(size_t i=first+1; i<last; i++)
+  {
+    double px = double(contour[i][0])-ax;
+    double py = double(contour[i][1])-ay;
+    double distance = (length>0.0)?std::fabs(px*dy - py*dx)/length:std::sqrt(px*px + py*py);
+    if(distance>worstDistance)
+    {
+      worstDistance = distance;
+      worst = i;
+    }
+  }
+
+  if(worstDistance<=tolerance)
+    return;
+
+  keep[worst] = true;
+  douglasPeucker(contour, first, worst, tolerance, keep);
+  douglasPeucker(contour, worst, last, tolerance, keep);
+}
+
+//##################################################################################################
+//! Closed contours are split at the first vertex and the vertex farthest from it.
+void simplify(Contour& contour, double tolerance)
+{
+  if(contour.size()<4)
+    return;
+
+  size_t far=0;
+  double farDistance=-1.0;
+  for(size_t i=1; i<contour.size(); i++)
+  {
+    double dx = double(contour[i][0]-contour[0][0]);
+    double dy = double(contour[i][1]-contour[0][1]);
+    double distance = dx*dx + dy*dy;
+    if(distance>farDistance)
+    {
+      farDistance = distance;
+      far = i;
+    }
+  }
+
+  Contour closed = contour;
+  closed.push_back(contour.front());
+
+  std::vector<bool> keep(closed.size(), false);
+  keep[0] = true;
+  keep[far] = true;
+  douglasPeucker(closed, 0, far, tolerance, keep);
+  douglasPeucker(closed, far, closed.size()-1, tolerance, keep);
+
+  Contour simplified;
+  for(size_t i=0; i+1<closed.size(); i++)
+    if(keep[i])
+      simplified.push_back(closed[i]);
+
+  // Small regions would collapse to a line, keep those as they are.
+  if(simplified.size()>=3)
+    contour.swap(simplified);
+}
+}
+
+//##################################################################################################
+std::vector<LabelPolygon> traceLabelPolygons(const tp_image_utils::ByteMap& src, float tolerance)
+{
+  std::vector<LabelPolygon> polygons;
+
+  auto w = int64_t(src.width());
+  auto h = int64_t(src.height());
+  if(w<1 || h<1)
+    return polygons;
+
+  const uint8_t* s = src.constData();
+  VertexIds_lt ids{size_t(w+2)};
+
+  // Pixels outside the image are 0, which is never traced.
+  auto label = [&](int64_t x, int64_t y) -> uint8_t
+  {
+    return (x<0 || y<0 || x>=w || y>=h)?0:s[y*w+x];
+  };
+
+  //-- Emit segments for each band of cell rows ----------------------------------------------------
+  // Cell (cx,cy) has the pixels (cx,cy), (cx+1,cy), (cx+1,cy+1) and (cx,cy+1) as its corners,
+  // cells start at -1 so that regions touching the edge of the image are closed.
+  std::vector<std::vector<Segment_lt>> bandSegments(threadCount()+1);
+  parallelFor(size_t(h+1), 16, [&](size_t begin, size_t end, size_t range)
+  {
+    auto& segments = bandSegments.at(range);
+    for(auto cy=int64_t(begin)-1; cy<int64_t(end)-1; cy++)
+    {
+      for(int64_t cx=-1; cx<w; cx++)
+      {
+        // Corners in clockwise order and the edge after each corner, top, right, bottom, left.
+        std::array<uint8_t, 4> corners{label(cx, cy), label(cx+1, cy), label(cx+1, cy+1), label(cx, cy+1)};
+        if(corners[0]==corners[1] && corners[1]==corners[2] && corners[2]==corners[3])
+          continue;
+
+        static constexpr std::array<std::array<int64_t, 2>, 4> offsets{{{0, 0}, {1, 0}, {1, 1}, {0, 1}}};
+        std::array<uint64_t, 4> edges
+        {
+          ids.id(cx  , cy  , 0),
+          ids.id(cx+1, cy  , 1),
+          ids.id(cx  , cy+1, 0),
+          ids.id(cx  , cy  , 1)
+        };
+
+        for(size_t c=0; c<4; c++)
+        {
+          uint8_t l = corners[c];
+          if(!l)
+            continue;
+
+          // Only handle each label once per cell, at its first corner.
+          bool seen=false;
+          for(size_t p=0; p<c; p++)
+            seen |= (corners[p]==l);
+          if(seen)
+            continue;
+
+          // Each run of inside corners is cut off by a segment from the edge entering the run to the
+          // edge leaving it, so diagonal corners are never joined.
+          for(size_t k=0; k<4; k++)
+          {
+            bool inside     = corners[k]==l;
+            bool nextInside = corners[(k+1)&3]==l;
+            if(inside || !nextInside)
+              continue;
+
+            size_t e=(k+1)&3;
+            while(corners[(e+1)&3]==l)
+              e = (e+1)&3;
+
+            const auto& o = offsets[(k+1)&3];
+            segments.push_back({edges[k], edges[e], uint32_t((cy+o[1])*w + cx+o[0]), l, uint8_t((k<2)?1:0)});
+          }
+        }
+      }
+    }
+  });
+
+  //-- Stitch the segments into loops, the start of a segment is unique per label ----------------
+  std::vector<Segment_lt> segments;
+  for(auto& band : bandSegments)
+    segments.insert(segments.end(), band.begin(), band.end());
+
+  // A vertex is on the boundary of at most 2 labels, the pixels either side of it, so the start of
+  // a segment is identified by its vertex and which side is inside. Only the vertices on a boundary
+  // are stored, sorted by that key.
+  const auto none = uint32_t(-1);
+  std::vector<std::pair<uint64_t, uint32_t>> starts(segments.size());
+  parallelFor(segments.size(), 1<<16, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t i=begin; i<end; i++)
+      starts[i] = {segments[i].from*2 + segments[i].side, uint32_t(i)};
+  });
+  std::sort(starts.begin(), starts.end());
+
+  auto nextSegment = [&](const Segment_lt& segment)
+  {
+    int64_t x;
+    int64_t y;
+    ids.firstPixel(segment.to, x, y);
+    uint64_t key = segment.to*2 + ((label(x, y)==segment.label)?0:1);
+    auto i = std::lower_bound(starts.begin(), starts.end(), std::make_pair(key, uint32_t(0)));
+    return (i!=starts.end() && i->first==key)?i->second:none;
+  };
+
+  struct Loop_lt
+  {
+    uint32_t pixel;
+    uint8_t label;
+    Contour contour;
+    double area;
+  };
+
+  std::vector<Loop_lt> loops;
+  std::vector<bool> visited(segments.size(), false);
+  for(size_t i=0; i<segments.size(); i++)
+  {
+    if(visited[i])
+      continue;
+
+    Loop_lt& loop = loops.emplace_back();
+    loop.label = segments[i].label;
+    loop.pixel = segments[i].pixel;
+    for(size_t j=i; !visited[j];)
+    {
+      visited[j] = true;
+      loop.contour.push_back(ids.position(segments[j].from));
+
+      // Drop vertices in the middle of straight runs.
+      size_t n = loop.contour.size();
+      if(n>=3 && collinear(loop.contour[n-3], loop.contour[n-2], loop.contour[n-1]))
+        loop.contour.erase(loop.contour.end()-2);
+
+      uint32_t following = nextSegment(segments[j]);
+      if(following==none)
+        break;
+      j = following;
+    }
+
+    // The straight run check again for the last and first vertices, where the loop closes. Removing
+    // one can make the other straight so repeat until neither changes.
+    for(bool changed=true; changed && loop.contour.size()>=3;)
+    {
+      changed = false;
+      size_t n = loop.contour.size();
+      if(collinear(loop.contour[n-2], loop.contour[n-1], loop.contour[0]))
+      {
+        loop.contour.pop_back();
+        changed = true;
+      }
+      else if(collinear(loop.contour[n-1], loop.contour[0], loop.contour[1]))
+      {
+        loop.contour.erase(loop.contour.begin());
+        changed = true;
+      }
+    }
+  }
+
+  //-- Simplify and measure the loops in parallel --------------------------------------------------
+  parallelFor(loops.size(), 64, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t i=begin; i<end; i++)
+    {
+      if(tolerance>0.0f)
+        simplify(loops[i].contour, double(tolerance));
+      loops[i].area = signedArea(loops[i].contour);
+    }
+  });
+
+  //-- Outlines wind one way and holes the other, holes go to the outline of their component -------
+  // Each 4 connected region has exactly one outline, so the component of a pixel inside a hole's
+  // boundary identifies the outline around it.
+  size_t componentCount=0;
+  std::vector<uint32_t> components = labelComponents(src, componentCount);
+  std::vector<size_t> outlineOf(componentCount+1, 0);
+
+  for(auto& loop : loops)
+  {
+    if(loop.area<0.0)
+    {
+      outlineOf[components[loop.pixel]] = polygons.size();
+      LabelPolygon& polygon = polygons.emplace_back();
+      polygon.label = loop.label;
+      polygon.outline = std::move(loop.contour);
+    }
+  }
+
+  for(auto& loop : loops)
+    if(loop.area>0.0)
+      polygons[outlineOf[components[loop.pixel]]].holes.push_back(std::move(loop.contour));
+
+  return polygons;
+}
+
+//##################################################################################################
+std::vector<uint32_t> labelComponents(const tp_image_utils::ByteMap& src, size_t& count)
+{
+  size_t w = src.width();
+  size_t h = src.height();
+  const uint8_t* s = src.constData();
+
+  std::vector<uint32_t> parent(w*h);
+
+  auto find = [&](uint32_t i)
+  {
+    while(parent[i]!=i)
+    {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+
+  // Roots are always the lowest index in their set, so the bands only ever write to their own rows.
+  auto unite = [&](uint32_t a, uint32_t b)
+  {
+    a = find(a);
+    b = find(b);
+    if(a<b)
+      parent[b] = a;
+    else if(b<a)
+      parent[a] = b;
+  };
+
+  //-- Join pixels within each band ----------------------------------------------------------------
+  std::vector<size_t> bandStarts(threadCount()+1, 0);
+  parallelFor(h, 16, [&](size_t begin, size_t end, size_t range)
+  {
+    bandStarts.at(range) = begin;
+    for(size_t y=begin; y<end; y++)
+    {
+      for(size_t x=0; x<w; x++)
+      {
+        auto i = uint32_t(y*w+x);
+        parent[i] = i;
+        if(!s[i])
+          continue;
+
+        if(x>0 && s[i-1]==s[i])
+          unite(i-1, i);
+
+        if(y>begin && s[i-w]==s[i])
+          unite(uint32_t(i-w), i);
+      }
+    }
+  });
+
+  //-- Join across the band edges ------------------------------------------------------------------
+  for(size_t b=1; b<bandStarts.size(); b++)
+  {
+    size_t y = bandStarts[b];
+    if(y<1)
+      continue;
+
+    for(size_t x=0; x<w; x++)
+    {
+      auto i = uint32_t(y*w+x);
+      if(s[i] && s[i-w]==s[i])
+        unite(uint32_t(i-w), i);
+    }
+  }
+
+  //-- Number the components in raster order -------------------------------------------------------
+  std::vector<uint32_t> components(w*h, 0);
+  count=0;
+  for(uint32_t i=0; i<w*h; i++)
+  {
+    if(!s[i])
+      continue;
+
+    uint32_t root = find(i);
+    if(root==i)
+      components[i] = uint32_t(++count);
+    else
+      components[i] = components[root];
+  }
+
+  return components;
+}
+
+}
@@ -0,0 +1,93 @@
+#include "tp_pipeline_image_utils/functions/DrawMask.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <cstring>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+static_assert(sizeof(TPPixel)==4, "The blend expects 4 byte pixels.");
+
+//##################################################################################################
+//! Blend a 4 channel pixel, alpha is in the range 0 to 256.
+uint32_t blend(uint32_t dst, uint32_t src, uint32_t alpha)
+{
+  uint32_t inverse = 256-alpha;
+  uint32_t rb = (((src     &0x00FF00FFu)*alpha + ( dst     &0x00FF00FFu)*inverse) >> 8) & 0x00FF00FFu;
+  uint32_t ga = ((((src>>8)&0x00FF00FFu)*alpha + ((dst>>8)&0x00FF00FFu)*inverse)     ) & 0xFF00FF00u;
+  return rb | ga;
+}
+
+//##################################################################################################
+//! Set the high bit of each byte of x that is zero.
+uint64_t zeroBytes(uint64_t x)
+{
+  constexpr uint64_t low  = 0x7F7F7F7F7F7F7F7Full;
+  return ~(((x & low) + low) | x | low);
+}
+}
+
+//##################################################################################################
+bool drawMaskBlend(tp_image_utils::ColorMap& image,
+                   TPPixel color,
+                   const tp_image_utils::ByteMap& mask,
+                   uint8_t value,
+                   uint8_t opacity)
+{
+  if(image.width()!=mask.width() || image.height()!=mask.height())
+    return false;
+
+  size_t size = image.size();
+  TPPixel* pixels = image.data();
+  const uint8_t* m = mask.constData();
+
+  uint32_t src;
+  std::memcpy(&src, &color, 4);
+  uint32_t alpha = uint32_t(opacity) + (uint32_t(opacity)>>7);
+  uint64_t broadcast = uint64_t(value) * 0x0101010101010101ull;
+
+  auto drawPixel = [&](size_t i)
+  {
+    if(alpha==256)
+    {
+      pixels[i] = color;
+      return;
+    }
+
+    uint32_t dst;
+    std::memcpy(&dst, pixels+i, 4);
+    dst = blend(dst, src, alpha);
+    std::memcpy(static_cast<void*>(pixels+i), &dst, 4);
+  };
+
+  if(alpha==0)
+    return true;
+
+  size_t words = size/8;
+  parallelFor(words, 4096, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t w=begin; w<end; w++)
+    {
+      uint64_t v;
+      std::memcpy(&v, m+w*8, 8);
+      uint64_t hits = zeroBytes(v ^ broadcast);
+      if(!hits)
+        continue;
+
+      size_t base = w*8;
+      for(size_t b=0; b<8; b++)
+        if((hits>>(b*8+7))&1)
+          drawPixel(base+b);
+    }
+  });
+
+  for(size_t i=words*8; i<size; i++)
+    if(m[i]==value)
+      drawPixel(i);
+
+  return true;
+}
+
+}
@@ -0,0 +1,525 @@
+#include "tp_pipeline_image_utils/functions/Expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <locale>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+constexpr size_t lanes = CompiledExpression::lanes;
+
+//##################################################################################################
+enum class Op_lt : uint8_t
+{
+  Constant,
+  Variable,
+
+  Neg,
+  Not,
+  Abs,
+  Sqrt,
+  Floor,
+
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Mod,
+  Min,
+  Max,
+  Lt,
+  Le,
+  Gt,
+  Ge,
+  Eq,
+  Ne,
+  And,
+  Or,
+
+  Select,
+  Clamp
+};
+
+//##################################################################################################
+template<typename F>
+void forLanes(float* d, const float* a, const float* b, const float* c, F f)
+{
+  for(size_t l=0; l<lanes; l++)
+    d[l] = f(a[l], b[l], c[l]);
+}
+
+//##################################################################################################
+//! Run a single operation over a block of lanes, this is also used to fold constants.
+void runOp(Op_lt op, float* d, const float* a, const float* b, const float* c)
+{
+  switch(op)
+  {
+  case Op_lt::Constant: [[fallthrough]];
+  case Op_lt::Variable: break;
+
+  case Op_lt::Neg:    forLanes(d, a, b, c, [](float x, float  , float  ){return -x;                       }); break;
+  case Op_lt::Not:    forLanes(d, a, b, c, [](float x, float  , float  ){return (x==0.0f)?1.0f:0.0f;      }); break;
+  case Op_lt::Abs:    forLanes(d, a, b, c, [](float x, float  , float  ){return std::fabs(x);             }); break;
+  case Op_lt::Sqrt:   forLanes(d, a, b, c, [](float x, float  , float  ){return std::sqrt(tpMax(0.0f, x)); }); break;
+  case Op_lt::Floor:  forLanes(d, a, b, c, [](float x, float  , float  ){return std::floor(x);            }); break;
+
+  case Op_lt::Add:    forLanes(d, a, b, c, [](float x, float y, float  ){return x+y;                      }); break;
+  case Op_lt::Sub:    forLanes(d, a, b, c, [](float x, float y, float  ){return x-y;                      }); break;
+  case Op_lt::Mul:    forLanes(d, a, b, c, [](float x, float y, float  ){return x*y;                      }); break;
+  case Op_lt::Div:    forLanes(d, a, b, c, [](float x, float y, float  ){return (y!=0.0f)?x/y:0.0f;       }); break;
+  case Op_lt::Mod:    forLanes(d, a, b, c, [](float x, float y, float  ){return (y!=0.0f)?std::fmod(x, y):0.0f;}); break;
+  case Op_lt::Min:    forLanes(d, a, b, c, [](float x, float y, float  ){return tpMin(x, y);              }); break;
+  case Op_lt::Max:    forLanes(d, a, b, c, [](float x, float y, float  ){return tpMax(x, y);              }); break;
+  case Op_lt::Lt:     forLanes(d, a, b, c, [](float x, float y, float  ){return (x< y)?1.0f:0.0f;         }); break;
+  case Op_lt::Le:     forLanes(d, a, b, c, [](float x, float y, float  ){return (x<=y)?1.0f:0.0f;         }); break;
+  case Op_lt::Gt:     forLanes(d, a, b, c, [](float x, float y, float  ){return (x> y)?1.0f:0.0f;         }); break;
+  case Op_lt::Ge:     forLanes(d, a, b, c, [](float x, float y, float  ){return (x>=y)?1.0f:0.0f;         }); break;
+  case Op_lt::Eq:     forLanes(d, a, b, c, [](float x, float y, float  ){return (x==y)?1.0f:0.0f;         }); break;
+  case Op_lt::Ne:     forLanes(d, a, b, c, [](float x, float y, float  ){return (x!=y)?1.0f:0.0f;         }); break;
+  case Op_lt::And:    forLanes(d, a, b, c, [](float x, float y, float  ){return (x!=0.0f && y!=0.0f)?1.0f:0.0f;}); break;
+  case Op_lt::Or:     forLanes(d, a, b, c, [](float x, float y, float  ){return (x!=0.0f || y!=0.0f)?1.0f:0.0f;}); break;
+
+  case Op_lt::Select: forLanes(d, a, b, c, [](float x, float y, float z){return (x!=0.0f)?y:z;            }); break;
+  case Op_lt::Clamp:  forLanes(d, a, b, c, [](float x, float y, float z){return tpMin(tpMax(x, y), z);    }); break;
+  }
+}
+
+//##################################################################################################
+struct Node_lt
+{
+  Op_lt op{Op_lt::Constant};
+  float value{0.0f};
+  size_t variable{0};
+  std::vector<std::unique_ptr<Node_lt>> args;
+};
+
+using NodePtr_lt = std::unique_ptr<Node_lt>;
+
+//##################################################################################################
+NodePtr_lt makeConstant(float value)
+{
+  auto node = std::make_unique<Node_lt>();
+  node->op = Op_lt::Constant;
+  node->value = value;
+  return node;
+}
+
+//##################################################################################################
+//! Build an operation node, if all of the arguments are constant it is folded into a constant.
+NodePtr_lt makeOp(Op_lt op, NodePtr_lt a, NodePtr_lt b=NodePtr_lt(), NodePtr_lt c=NodePtr_lt())
+{
+  auto node = std::make_unique<Node_lt>();
+  node->op = op;
+
+  bool constant=true;
+  for(auto arg : {&a, &b, &c})
+  {
+    if(!(*arg))
+      continue;
+    constant = constant && ((*arg)->op == Op_lt::Constant);
+    node->args.push_back(std::move(*arg));
+  }
+
+  if(!constant)
+    return node;
+
+  float values[3][lanes]={};
+  for(size_t i=0; i<node->args.size(); i++)
+    for(size_t l=0; l<lanes; l++)
+      values[i][l] = node->args.at(i)->value;
+
+  float result[lanes];
+  runOp(op, result, values[0], values[1], values[2]);
+  return makeConstant(result[0]);
+}
+
+//##################################################################################################
+class Parser_lt
+{
+public:
+  //################################################################################################
+  Parser_lt(const std::string& text, std::vector<std::string>& variables):
+    m_text(text),
+    m_variables(variables)
+  {
+
+  }
+
+  //################################################################################################
+  NodePtr_lt parse(std::string& error)
+  {
+    NodePtr_lt node = parseTernary();
+    skipSpace();
+    if(m_error.empty() && m_pos<m_text.size())
+      fail("Unexpected character");
+
+    if(!m_error.empty())
+    {
+      error = m_error;
+      return NodePtr_lt();
+    }
+    return node;
+  }
+
+private:
+  const std::string& m_text;
+  std::vector<std::string>& m_variables;
+  size_t m_pos{0};
+  std::string m_error;
+
+  //################################################################################################
+  NodePtr_lt fail(const std::string& message)
+  {
+    if(m_error.empty())
+      m_error = message + " at position " + std::to_string(m_pos) + " in: " + m_text;
+    return makeConstant(0.0f);
+  }
+
+  //################################################################################################
+  void skipSpace()
+  {
+    while(m_pos<m_text.size() && std::isspace(static_cast<unsigned char>(m_text.at(m_pos))))
+      m_pos++;
+  }
+
+  //################################################################################################
+  bool accept(const char* token)
+  {
+    skipSpace();
+    size_t len = std::char_traits<char>::length(token);
+    if(m_text.compare(m_pos, len, token) != 0)
+      return false;
+
+    // Don't match the "<" of "<=" or the "!" of "!=".
+    if(len==1 && m_pos+1<m_text.size() && m_text.at(m_pos+1)=='=' && std::string("<>!=").find(token[0])!=std::string::npos)
+      return false;
+
+    m_pos+=len;
+    return true;
+  }
+
+  //################################################################################################
+  NodePtr_lt parseTernary()
+  {
+    NodePtr_lt node = parseBinary(0);
+    if(accept("?"))
+    {
+      NodePtr_lt a = parseTernary();
+      if(!accept(":"))
+        return fail("Expected ':'");
+      NodePtr_lt b = parseTernary();
+      return makeOp(Op_lt::Select, std::move(node), std::move(a), std::move(b));
+    }
+    return node;
+  }
+
+  //################################################################################################
+  //! Binary operators by level, lowest precedence first.
+  NodePtr_lt parseBinary(size_t level)
+  {
+    struct Operator
+    {
+      const char* token;
+      Op_lt op;
+    };
+
+    static const std::vector<std::vector<Operator>> levels =
+    {
+      {{"||", Op_lt::Or}},
+      {{"&&", Op_lt::And}},
+      {{"==", Op_lt::Eq}, {"!=", Op_lt::Ne}},
+      {{"<=", Op_lt::Le}, {">=", Op_lt::Ge}, {"<", Op_lt::Lt}, {">", Op_lt::Gt}},
+      {{"+", Op_lt::Add}, {"-", Op_lt::Sub}},
+      {{"*", Op_lt::Mul}, {"/", Op_lt::Div}, {"%", Op_lt::Mod}}
+    };
+
+    if(level>=levels.size())
+      return parseUnary();
+
+    NodePtr_lt node = parseBinary(level+1);
+    for(;;)
+    {
+      bool found=false;
+      for(const auto& o : levels.at(level))
+      {
+        if(accept(o.token))
+        {
+          node = makeOp(o.op, std::move(node), parseBinary(level+1));
+          found=true;
+          break;
+        }
+      }
+
+      if(!found || !m_error.empty())
+        return node;
+    }
+  }
+
+  //################################################################################################
+  NodePtr_lt parseUnary()
+  {
+    if(accept("-"))
+      return makeOp(Op_lt::Neg, parseUnary());
+    if(accept("+"))
+      return parseUnary();
+    if(accept("!"))
+      return makeOp(Op_lt::Not, parseUnary());
+    return parsePrimary();
+  }
+
+  //################################################################################################
+  NodePtr_lt parsePrimary()
+  {
+    skipSpace();
+    if(m_pos>=m_text.size())
+      return fail("Unexpected end of expression");
+
+    char c = m_text.at(m_pos);
+
+    if(accept("("))
+    {
+      NodePtr_lt node = parseTernary();
+      if(!accept(")"))
+        return fail("Expected ')'");
+      return node;
+    }
+
+    if(std::isdigit(static_cast<unsigned char>(c)) || c=='.')
+    {
+      size_t begin = m_pos;
+      while(m_pos<m_text.size() && (std::isdigit(static_cast<unsigned char>(m_text.at(m_pos))) || m_text.at(m_pos)=='.'))
+        m_pos++;
+
+      // Parse with the classic locale so that '.' is the decimal point whatever the user's locale.
+      std::istringstream stream(m_text.substr(begin, m_pos-begin));
+      stream.imbue(std::locale::classic());
+      float value=0.0f;
+      stream >> value;
+      if(stream.fail() || stream.peek()!=std::char_traits<char>::eof())
+        return fail("Invalid number");
+      return makeConstant(value);
+    }
+
+    if(std::isalpha(static_cast<unsigned char>(c)) || c=='_')
+    {
+      size_t begin = m_pos;
+      while(m_pos<m_text.size() && (std::isalnum(static_cast<unsigned char>(m_text.at(m_pos))) || m_text.at(m_pos)=='_' || m_text.at(m_pos)=='.'))
+        m_pos++;
+      std::string name = m_text.substr(begin, m_pos-begin);
+
+      if(accept("("))
+        return parseFunction(name);
+
+      auto node = std::make_unique<Node_lt>();
+      node->op = Op_lt::Variable;
+      auto i = std::find(m_variables.begin(), m_variables.end(), name);
+      node->variable = size_t(i-m_variables.begin());
+      if(i==m_variables.end())
+        m_variables.push_back(name);
+      return node;
+    }
+
+    return fail("Unexpected character");
+  }
+
+  //################################################################################################
+  NodePtr_lt parseFunction(const std::string& name)
+  {
+    std::vector<NodePtr_lt> args;
+    if(!accept(")"))
+    {
+      do
+      {
+        args.push_back(parseTernary());
+      }
+      while(m_error.empty() && accept(","));
+
+      if(!accept(")"))
+        return fail("Expected ')'");
+    }
+
+    struct Function
+    {
+      const char* name;
+      Op_lt op;
+      size_t args;
+    };
+
+    static const Function functions[] =
+    {
+      {"abs"  , Op_lt::Abs  , 1},
+      {"sqrt" , Op_lt::Sqrt , 1},
+      {"floor", Op_lt::Floor, 1},
+      {"min"  , Op_lt::Min  , 2},
+      {"max"  , Op_lt::Max  , 2},
+      {"clamp", Op_lt::Clamp, 3}
+    };
+
+    for(const auto& f : functions)
+    {
+      if(name != f.name)
+        continue;
+
+      if(args.size() != f.args)
+        return fail("Wrong number of arguments to " + name);
+
+      args.resize(3);
+      return makeOp(f.op, std::move(args[0]), std::move(args[1]), std::move(args[2]));
+    }
+
+    return fail("Unknown function " + name);
+  }
+};
+
+//##################################################################################################
+struct Instruction_lt
+{
+  Op_lt op;
+  uint32_t d;
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+};
+}
+
+//##################################################################################################
+struct CompiledExpression::Private
+{
+  std::vector<std::string> variables;
+
+  //-- Registers are laid out as variables, then constants, then temporaries -----------------------
+  std::vector<float> constants;
+  std::vector<Instruction_lt> code;
+  size_t registerCount{0};
+  uint32_t result{0};
+
+  //################################################################################################
+  uint32_t constantRegister(float value)
+  {
+    // Compare bit patterns, NaN never equals itself so it would get a new register each time.
+    auto bits = [](float v)
+    {
+      uint32_t b;
+      std::memcpy(&b, &v, sizeof(b));
+      return b;
+    };
+
+    for(size_t i=0; i<constants.size(); i++)
+      if(bits(constants.at(i)) == bits(value))
+        return uint32_t(variables.size()+i);
+    constants.push_back(value);
+    return uint32_t(variables.size()+constants.size()-1);
+  }
+
+  //################################################################################################
+  //! Pass one, allocate registers for variables and constants.
+  void collectConstants(const Node_lt* node)
+  {
+    if(node->op == Op_lt::Constant)
+      constantRegister(node->value);
+    for(const auto& arg : node->args)
+      collectConstants(arg.get());
+  }
+
+  //################################################################################################
+  //! Pass two, emit an instruction for each operation into its own temporary register.
+  uint32_t emit(const Node_lt* node)
+  {
+    if(node->op == Op_lt::Constant)
+      return constantRegister(node->value);
+
+    if(node->op == Op_lt::Variable)
+      return uint32_t(node->variable);
+
+    uint32_t args[3]={0, 0, 0};
+    for(size_t i=0; i<node->args.size(); i++)
+      args[i] = emit(node->args.at(i).get());
+
+    auto d = uint32_t(registerCount++);
+    code.push_back({node->op, d, args[0], args[1], args[2]});
+    return d;
+  }
+};
+
+//##################################################################################################
+CompiledExpression::CompiledExpression():
+  d(new Private())
+{
+
+}
+
+//##################################################################################################
+CompiledExpression::~CompiledExpression()
+{
+  delete d;
+}
+
+//##################################################################################################
+std::shared_ptr<const CompiledExpression> CompiledExpression::compile(const std::string& expression, std::string& error)
+{
+  static std::mutex mutex;
+  static std::map<std::string, std::shared_ptr<const CompiledExpression>> cache;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto i = cache.find(expression);
+    if(i!=cache.end())
+      return i->second;
+  }
+
+  std::shared_ptr<CompiledExpression> compiled(new CompiledExpression());
+  Private* p = compiled->d;
+
+  NodePtr_lt root = Parser_lt(expression, p->variables).parse(error);
+  if(!root)
+    return nullptr;
+
+  p->collectConstants(root.get());
+  p->registerCount = p->variables.size() + p->constants.size();
+  p->result = p->emit(root.get());
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if(cache.size()>=256)
+    cache.clear();
+  cache[expression] = compiled;
+  return compiled;
+}
+
+//##################################################################################################
+const std::vector<std::string>& CompiledExpression::variables() const
+{
+  return d->variables;
+}
+
+//##################################################################################################
+size_t CompiledExpression::scratchSize() const
+{
+  return d->registerCount*lanes;
+}
+
+//##################################################################################################
+void CompiledExpression::run(const float* const* inputs, float* scratch, float* result) const
+{
+  size_t nVariables = d->variables.size();
+
+  for(size_t v=0; v<nVariables; v++)
+    std::copy(inputs[v], inputs[v]+lanes, scratch+v*lanes);
+
+  for(size_t c=0; c<d->constants.size(); c++)
+    std::fill(scratch+(nVariables+c)*lanes, scratch+(nVariables+c+1)*lanes, d->constants.at(c));
+
+  for(const auto& i : d->code)
+    runOp(i.op, scratch+i.d*lanes, scratch+i.a*lanes, scratch+i.b*lanes, scratch+i.c*lanes);
+
+  std::copy(scratch+d->result*lanes, scratch+(d->result+1)*lanes, result);
+}
+
+}
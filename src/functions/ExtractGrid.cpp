@@ -0,0 +1,73 @@
+#include "tp_pipeline_image_utils/functions/ExtractGrid.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include "tp_image_utils_functions/ExtractRect.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+tp_image_utils::ColorMap extractGrid(const tp_image_utils::ColorMap& src,
+                                     const tp_image_utils::Grid& grid,
+                                     size_t width,
+                                     size_t height,
+                                     std::vector<std::string>& errors)
+{
+  // Bands are cut on cell boundaries that fall on whole output rows. With g = gcd(height, cellRows)
+  // that is every cellRows/g cells, which is height/g output rows.
+  size_t cellRows = grid.yCells;
+  size_t units = (cellRows>0 && height>0)?std::gcd(height, cellRows):0;
+  if(units<2 || threadCount()<2)
+    return tp_image_utils_functions::ExtractRect::extractRect(src, grid, width, height, errors);
+
+  size_t unitCells = cellRows / units;
+  size_t unitRows = height / units;
+
+  std::vector<tp_image_utils::ColorMap> bands(threadCount()+1);
+  std::vector<std::vector<std::string>> bandErrors(bands.size());
+  std::vector<size_t> bandRows(bands.size(), 0);
+
+  parallelFor(units, 1, [&](size_t begin, size_t end, size_t range)
+  {
+    tp_image_utils::Grid band = grid;
+    band.origin.x = grid.origin.x + grid.yAxis.x*float(begin*unitCells);
+    band.origin.y = grid.origin.y + grid.yAxis.y*float(begin*unitCells);
+    band.yCells = (end - begin)*unitCells;
+
+    bandRows[range] = (end - begin)*unitRows;
+    bands[range] = tp_image_utils_functions::ExtractRect::extractRect(src, band, width, bandRows[range], bandErrors[range]);
+  });
+
+  for(const auto& bandError : bandErrors)
+    for(const auto& error : bandError)
+      if(std::find(errors.begin(), errors.end(), error) == errors.end())
+        errors.push_back(error);
+
+  tp_image_utils::ColorMap dst;
+  dst.setSize(width, height);
+
+  TPPixel* d = dst.data();
+  for(size_t b=0; b<bands.size(); b++)
+  {
+    if(bandRows[b]==0)
+      continue;
+
+    const auto& band = bands.at(b);
+    if(band.width()!=width || band.height()!=bandRows[b])
+    {
+      errors.emplace_back("Grid band has an unexpected size, warping the whole grid instead.");
+      return tp_image_utils_functions::ExtractRect::extractRect(src, grid, width, height, errors);
+    }
+
+    std::memcpy(static_cast<void*>(d), band.constData(), band.size()*sizeof(TPPixel));
+    d += band.size();
+  }
+
+  return dst;
+}
+
+}
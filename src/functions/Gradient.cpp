@@ -0,0 +1,346 @@
+#include "tp_pipeline_image_utils/functions/Gradient.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+//##################################################################################################
+//! Source rows for each channel with one pixel of clamped padding on either side.
+class SourceRows_lt
+{
+public:
+  //################################################################################################
+  SourceRows_lt(const GradientSource& src):
+    m_src(src),
+    m_w(src.width()),
+    m_h(src.height()),
+    m_channels((src.color && !src.gray)?3:1)
+  {
+    for(auto& row : m_rows)
+      row.resize((m_w+2)*m_channels);
+
+    // Map each padded x back to the source once, -1 means the fill value.
+    size_t sw = m_w - m_src.border*2;
+    m_xMap.resize(m_w+2);
+    for(size_t x=0; x<m_w+2; x++)
+    {
+      int64_t px = tpBound(int64_t(0), int64_t(x)-1, int64_t(m_w)-1);
+      m_xMap[x] = borderCoordinate(px-int64_t(m_src.border), sw, m_src.mode);
+    }
+  }
+
+  //################################################################################################
+  size_t channels() const
+  {
+    return m_channels;
+  }
+
+  //################################################################################################
+  //! Returns row y clamped to the image, channel c starts at c*(width+2).
+  const int32_t* row(int64_t y)
+  {
+    y = tpBound(int64_t(0), y, int64_t(m_h)-1);
+    size_t slot = size_t(y)%3;
+    if(m_tags[slot]!=y)
+    {
+      load(y, m_rows[slot]);
+      m_tags[slot] = y;
+    }
+    return m_rows[slot].data();
+  }
+
+private:
+  const GradientSource& m_src;
+  size_t m_w;
+  size_t m_h;
+  size_t m_channels;
+  std::vector<int64_t> m_xMap;
+  std::vector<int32_t> m_rows[3];
+  int64_t m_tags[3]={-1, -1, -1};
+
+  //################################################################################################
+  void load(int64_t y, std::vector<int32_t>& row)
+  {
+    size_t sh = m_h - m_src.border*2;
+    int64_t sy = borderCoordinate(y-int64_t(m_src.border), sh, m_src.mode);
+    size_t stride = m_w+2;
+    size_t sw = m_w - m_src.border*2;
+
+    if(m_src.color)
+    {
+      const TPPixel* in = (sy<0)?nullptr:(m_src.color->constData() + size_t(sy)*sw);
+      for(size_t x=0; x<stride; x++)
+      {
+        int64_t sx = m_xMap[x];
+        TPPixel p = (in && sx>=0)?in[sx]:m_src.fillColor;
+        if(m_channels==1)
+          row[x] = (int32_t(p.r) + int32_t(p.g) + int32_t(p.b)) / 3;
+        else
+        {
+          row[x         ] = p.r;
+          row[x+stride  ] = p.g;
+          row[x+stride*2] = p.b;
+        }
+      }
+    }
+    else
+    {
+      const uint8_t* in = (sy<0)?nullptr:(m_src.byte->constData() + size_t(sy)*sw);
+      for(size_t x=0; x<stride; x++)
+      {
+        int64_t sx = m_xMap[x];
+        row[x] = (in && sx>=0)?in[sx]:m_src.fillValue;
+      }
+    }
+  }
+};
+
+//##################################################################################################
+//! The Sobel gradients of one row, per channel, plus the structure tensor summed over channels.
+/*!
+Each gradient is at most 1020 so the tensor of 3 channels summed over a 3x3 window fits in 32 bits,
+which keeps the loops below to 32 bit lanes.
+*/
+struct GradientRow_lt
+{
+  std::vector<int32_t> gx;  //!< channels*width
+  std::vector<int32_t> gy;  //!< channels*width
+  std::vector<int32_t> xx;  //!< width
+  std::vector<int32_t> yy;  //!< width
+  std::vector<int32_t> xy;  //!< width
+};
+
+//##################################################################################################
+void computeGradientRow(SourceRows_lt& rows, int64_t y, size_t w, GradientRow_lt& out)
+{
+  size_t channels = rows.channels();
+  size_t stride = w+2;
+
+  const int32_t* r0 = rows.row(y-1);
+  const int32_t* r1 = rows.row(y  );
+  const int32_t* r2 = rows.row(y+1);
+
+  out.gx.resize(channels*w);
+  out.gy.resize(channels*w);
+  out.xx.assign(w, 0);
+  out.yy.assign(w, 0);
+  out.xy.assign(w, 0);
+
+  int32_t* __restrict xx = out.xx.data();
+  int32_t* __restrict yy = out.yy.data();
+  int32_t* __restrict xy = out.xy.data();
+
+  // Rows are planar so each loop is a straight run over one channel that the compiler vectorises.
+  for(size_t c=0; c<channels; c++)
+  {
+    const int32_t* __restrict a = r0 + c*stride;
+    const int32_t* __restrict b = r1 + c*stride;
+    const int32_t* __restrict d = r2 + c*stride;
+    int32_t* __restrict gx = out.gx.data() + c*w;
+    int32_t* __restrict gy = out.gy.data() + c*w;
+
+    for(size_t x=0; x<w; x++)
+    {
+      gx[x] = (a[x+2] + 2*b[x+2] + d[x+2]) - (a[x] + 2*b[x] + d[x]);
+      gy[x] = (d[x] + 2*d[x+1] + d[x+2]) - (a[x] + 2*a[x+1] + a[x+2]);
+    }
+
+    for(size_t x=0; x<w; x++)
+    {
+      xx[x] += gx[x]*gx[x];
+      yy[x] += gy[x]*gy[x];
+      xy[x] += gx[x]*gy[x];
+    }
+  }
+}
+
+//##################################################################################################
+void thresholdEdges(const GradientRow_lt& g, size_t w, int32_t limit, uint8_t* __restrict out)
+{
+  const int32_t* __restrict xx = g.xx.data();
+  const int32_t* __restrict yy = g.yy.data();
+  for(size_t x=0; x<w; x++)
+    out[x] = ((xx[x]+yy[x])>limit)?255:0;
+}
+
+//##################################################################################################
+//! Threshold the smaller eigenvalue of the tensor summed over 3 columns of row sums.
+/*!
+The smaller eigenvalue (a+c)/2 - sqrt(((a-c)/2)^2 + b^2) is above the limit when e = a+c-2*limit is
+positive and e^2 > (a-c)^2 + (2b)^2. Everything is an integer well below 2^53 so the doubles are
+exact and there is no sqrt. The row sums have one padding column either side.
+*/
+void thresholdCorners(const int32_t* __restrict sxx,
+                      const int32_t* __restrict syy,
+                      const int32_t* __restrict sxy,
+                      size_t w,
+                      double limit,
+                      uint8_t* __restrict out)
+{
+  for(size_t x=0; x<w; x++)
+  {
+    double a = double(sxx[x] + sxx[x+1] + sxx[x+2]);
+    double c = double(syy[x] + syy[x+1] + syy[x+2]);
+    double b = double(sxy[x] + sxy[x+1] + sxy[x+2]);
+    double e = a + c - 2.0*limit;
+    double h = a - c;
+    out[x] = ((e>0.0) & (e*e>h*h + 4.0*b*b))?255:0;
+  }
+}
+}
+
+//##################################################################################################
+size_t GradientSource::width() const
+{
+  return (color?color->width():(byte?byte->width():0)) + border*2;
+}
+
+//##################################################################################################
+size_t GradientSource::height() const
+{
+  return (color?color->height():(byte?byte->height():0)) + border*2;
+}
+
+//##################################################################################################
+tp_image_utils::ByteMap sobelDetect(const GradientSource& src,
+                                    GradientFeature feature,
+                                    size_t threshold,
+                                    FloatMap* magnitude,
+                                    FloatMap* orientation)
+{
+  size_t w = src.width();
+  size_t h = src.height();
+
+  tp_image_utils::ByteMap dst;
+  dst.setSize(w, h);
+
+  if(magnitude)
+  {
+    magnitude->setSize(w, h);
+    std::fill(magnitude->values.begin(), magnitude->values.end(), 0.0f);
+  }
+
+  if(orientation)
+  {
+    orientation->setSize(w, h);
+    std::fill(orientation->values.begin(), orientation->values.end(), 0.0f);
+  }
+
+  if(w<1 || h<1 || (!src.color && !src.byte) || w==src.border*2 || h==src.border*2)
+  {
+    uint8_t* d = dst.data();
+    for(size_t i=0; i<w*h; i++)
+      d[i] = 0;
+    return dst;
+  }
+
+  // Compare squared values, the Sobel gradient is 4 times the step size. Thresholds above the
+  // largest possible magnitude can't be reached so they are clamped to keep the limits in 32 bits.
+  auto t = int32_t(tpMin(threshold, size_t(1024)))*4;
+  int32_t edgeLimit = t*t;
+  double cornerLimit = double(edgeLimit)*9.0;
+
+  uint8_t* d = dst.data();
+
+  //-- Write the optional float outputs for row y from its gradient row ----------------------------
+  auto writeFloats = [&](size_t y, const GradientRow_lt& g)
+  {
+    if(magnitude)
+    {
+      float* m = magnitude->values.data() + y*w;
+      for(size_t x=0; x<w; x++)
+        m[x] = std::sqrt(float(g.xx[x]+g.yy[x])) * 0.25f;
+    }
+
+    if(orientation)
+    {
+      size_t channels = g.gx.size()/w;
+      float* o = orientation->values.data() + y*w;
+      for(size_t x=0; x<w; x++)
+      {
+        size_t best=0;
+        int64_t bestLength=-1;
+        for(size_t c=0; c<channels; c++)
+        {
+          int64_t gx = g.gx[c*w+x];
+          int64_t gy = g.gy[c*w+x];
+          if(gx*gx+gy*gy>bestLength)
+          {
+            bestLength = gx*gx+gy*gy;
+            best = c;
+          }
+        }
+        o[x] = std::atan2(float(g.gy[best*w+x]), float(g.gx[best*w+x]));
+      }
+    }
+  };
+
+  parallelFor(h, 16, [&](size_t begin, size_t end, size_t)
+  {
+    SourceRows_lt rows(src);
+
+    if(feature == GradientFeature::Edge)
+    {
+      GradientRow_lt g;
+      for(size_t y=begin; y<end; y++)
+      {
+        computeGradientRow(rows, int64_t(y), w, g);
+        thresholdEdges(g, w, edgeLimit, d + y*w);
+        writeFloats(y, g);
+      }
+      return;
+    }
+
+    //-- Corners need the tensor summed over 3 gradient rows ---------------------------------------
+    GradientRow_lt g[3];
+    int64_t tags[3]={-1, -1, -1};
+    auto gradientRow = [&](int64_t gyRow) -> const GradientRow_lt&
+    {
+      gyRow = tpBound(int64_t(0), gyRow, int64_t(h)-1);
+      size_t slot = size_t(gyRow)%3;
+      if(tags[slot]!=gyRow)
+      {
+        computeGradientRow(rows, gyRow, w, g[slot]);
+        tags[slot] = gyRow;
+      }
+      return g[slot];
+    };
+
+    // The row sums are padded by one clamped column either side so the column sum has no branches.
+    std::vector<int32_t> sums[3];
+    for(auto& sum : sums)
+      sum.resize(w+2);
+
+    for(size_t y=begin; y<end; y++)
+    {
+      const GradientRow_lt& g0 = gradientRow(int64_t(y)-1);
+      const GradientRow_lt& g1 = gradientRow(int64_t(y)  );
+      const GradientRow_lt& g2 = gradientRow(int64_t(y)+1);
+      writeFloats(y, g1);
+
+      const std::vector<int32_t> GradientRow_lt::* channels[3] = {&GradientRow_lt::xx, &GradientRow_lt::yy, &GradientRow_lt::xy};
+      for(size_t i=0; i<3; i++)
+      {
+        const int32_t* __restrict a = (g0.*channels[i]).data();
+        const int32_t* __restrict b = (g1.*channels[i]).data();
+        const int32_t* __restrict c = (g2.*channels[i]).data();
+        int32_t* __restrict s = sums[i].data()+1;
+        for(size_t x=0; x<w; x++)
+          s[x] = a[x] + b[x] + c[x];
+        s[-1] = s[0];
+        s[w] = s[w-1];
+      }
+
+      thresholdCorners(sums[0].data(), sums[1].data(), sums[2].data(), w, cornerLimit, d + y*w);
+    }
+  });
+
+  return dst;
+}
+
+}
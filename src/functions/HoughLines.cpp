@@ -0,0 +1,258 @@
+#include "tp_pipeline_image_utils/functions/HoughLines.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+constexpr double pi = 3.14159265358979323846;
+
+//##################################################################################################
+struct Accumulator_lt
+{
+  size_t angleBins{0};
+  size_t rhoBins{0};
+  double rhoStep{1.0};
+  double rhoOffset{0.0};
+  std::vector<double> cosTable;
+  std::vector<double> sinTable;
+  std::vector<uint32_t> counts;
+
+  //################################################################################################
+  size_t rhoBin(size_t a, double x, double y) const
+  {
+    double rho = x*cosTable[a] + y*sinTable[a] + rhoOffset;
+    return tpMin(rhoBins-1, size_t(tpMax(0.0, rho/rhoStep)));
+  }
+};
+
+//##################################################################################################
+//! The range of angle bins a pixel votes for, [begin, end) possibly wrapping past angleBins.
+void angleRange(const HoughLineParameters& params, const Accumulator_lt& acc, size_t i, size_t& begin, size_t& count)
+{
+  if(!params.orientation)
+  {
+    begin = 0;
+    count = acc.angleBins;
+    return;
+  }
+
+  // The gradient is the line normal, which is what the accumulator angle measures.
+  double a = double(params.orientation->values[i]);
+  a = std::fmod(a, pi);
+  if(a<0.0)
+    a += pi;
+
+  double binsPerRadian = double(acc.angleBins)/pi;
+  auto window = size_t(std::ceil(double(params.angleWindow)*binsPerRadian));
+  count = tpMin(acc.angleBins, window*2+1);
+  auto center = int64_t(a*binsPerRadian);
+  begin = size_t(((center-int64_t(window))%int64_t(acc.angleBins) + int64_t(acc.angleBins)) % int64_t(acc.angleBins));
+}
+
+//##################################################################################################
+template<typename F>
+void forAngles(const HoughLineParameters& params, const Accumulator_lt& acc, size_t i, F f)
+{
+  size_t begin;
+  size_t count;
+  angleRange(params, acc, i, begin, count);
+  for(size_t n=0; n<count; n++)
+  {
+    size_t a = begin+n;
+    if(a>=acc.angleBins)
+      a -= acc.angleBins;
+    f(a);
+  }
+}
+}
+
+//##################################################################################################
+std::vector<LineSegment> houghLines(const tp_image_utils::ByteMap& src, const HoughLineParameters& params)
+{
+  std::vector<LineSegment> segments;
+
+  size_t w = src.width();
+  size_t h = src.height();
+  if(w<1 || h<1)
+    return segments;
+
+  if(params.orientation && (params.orientation->width!=w || params.orientation->height!=h))
+    return houghLines(src, [&]{HoughLineParameters p=params; p.orientation=nullptr; return p;}());
+
+  auto maxDeviation = int64_t(tpMax(size_t(1), params.maxDeviation));
+  size_t minPoints = tpMax(size_t(2), params.minPoints);
+
+  Accumulator_lt acc;
+  acc.angleBins = tpMax(size_t(4), params.angleBins);
+  acc.rhoStep = double(maxDeviation);
+  double diagonal = std::sqrt(double(w*w + h*h));
+  acc.rhoOffset = diagonal;
+  acc.rhoBins = size_t(std::ceil(diagonal*2.0/acc.rhoStep))+1;
+  acc.cosTable.resize(acc.angleBins);
+  acc.sinTable.resize(acc.angleBins);
+  for(size_t a=0; a<acc.angleBins; a++)
+  {
+    double t = pi*double(a)/double(acc.angleBins);
+    acc.cosTable[a] = std::cos(t);
+    acc.sinTable[a] = std::sin(t);
+  }
+  acc.counts.assign(acc.angleBins*acc.rhoBins, 0);
+
+  //-- 0 not set, 1 set and waiting, 2 set and has voted, 3 claimed by a segment ------------------
+  std::vector<uint8_t> state(w*h, 0);
+  std::vector<size_t> order;
+  const uint8_t* s = src.constData();
+  for(size_t i=0; i<w*h; i++)
+  {
+    if(s[i])
+    {
+      state[i] = 1;
+      order.push_back(i);
+    }
+  }
+
+  std::mt19937 rng(0x5eed);
+  std::shuffle(order.begin(), order.end(), rng);
+
+  auto threshold = uint32_t(tpMax(size_t(2), minPoints/2));
+
+  auto vote = [&](size_t i, int direction)
+  {
+    double x = double(i%w);
+    double y = double(i/w);
+    size_t best=0;
+    uint32_t bestCount=0;
+    forAngles(params, acc, i, [&](size_t a)
+    {
+      uint32_t& c = acc.counts[a*acc.rhoBins + acc.rhoBin(a, x, y)];
+      c = uint32_t(int64_t(c)+direction);
+      if(c>bestCount)
+      {
+        bestCount = c;
+        best = a;
+      }
+    });
+    return std::make_pair(best, bestCount);
+  };
+
+  std::vector<size_t> corridor;
+  for(size_t i : order)
+  {
+    if(state[i]!=1)
+      continue;
+
+    state[i] = 2;
+    auto [angle, count] = vote(i, 1);
+    if(count<threshold)
+      continue;
+
+    //-- Walk the corridor along the line through this pixel -------------------------------------
+    double nx = acc.cosTable[angle];
+    double ny = acc.sinTable[angle];
+    double dx = -ny;
+    double dy =  nx;
+    double px = double(i%w);
+    double py = double(i/w);
+
+    corridor.clear();
+    for(int direction : {1, -1})
+    {
+      int64_t gap=0;
+      for(int64_t t=(direction>0)?0:-1; gap<=maxDeviation; t+=direction)
+      {
+        double cx = px + dx*double(t);
+        double cy = py + dy*double(t);
+        if(cx<-double(maxDeviation) || cy<-double(maxDeviation) || cx>double(w+size_t(maxDeviation)) || cy>double(h+size_t(maxDeviation)))
+          break;
+
+        bool found=false;
+        for(int64_t o=-maxDeviation; o<=maxDeviation; o++)
+        {
+          auto x = int64_t(std::lround(cx + nx*double(o)));
+          auto y = int64_t(std::lround(cy + ny*double(o)));
+          if(x<0 || y<0 || x>=int64_t(w) || y>=int64_t(h))
+            continue;
+
+          size_t j = size_t(y)*w + size_t(x);
+          if(state[j]==1 || state[j]==2)
+          {
+            corridor.push_back(j);
+            state[j] |= 4;
+            found=true;
+          }
+        }
+        gap = found?0:(gap+1);
+      }
+    }
+
+    // The corridor samples overlap, the 4 bit marks pixels that have already been collected.
+    for(size_t j : corridor)
+      state[j] &= 3;
+
+    if(corridor.size()<minPoints)
+      continue;
+
+    //-- Fit a line to the corridor pixels ---------------------------------------------------------
+    double mx=0.0;
+    double my=0.0;
+    for(size_t j : corridor)
+    {
+      mx += double(j%w);
+      my += double(j/w);
+    }
+    mx /= double(corridor.size());
+    my /= double(corridor.size());
+
+    double sxx=0.0;
+    double syy=0.0;
+    double sxy=0.0;
+    for(size_t j : corridor)
+    {
+      double x = double(j%w)-mx;
+      double y = double(j/w)-my;
+      sxx += x*x;
+      syy += y*y;
+      sxy += x*y;
+    }
+
+    double theta = 0.5*std::atan2(2.0*sxy, sxx-syy);
+    double ux = std::cos(theta);
+    double uy = std::sin(theta);
+
+    double tMin=0.0;
+    double tMax=0.0;
+    bool first=true;
+    for(size_t j : corridor)
+    {
+      double t = (double(j%w)-mx)*ux + (double(j/w)-my)*uy;
+      if(first || t<tMin) tMin = t;
+      if(first || t>tMax) tMax = t;
+      first=false;
+    }
+
+    LineSegment segment;
+    segment.x0 = float(mx + ux*tMin);
+    segment.y0 = float(my + uy*tMin);
+    segment.x1 = float(mx + ux*tMax);
+    segment.y1 = float(my + uy*tMax);
+    segment.points = corridor.size();
+    segments.push_back(segment);
+
+    //-- Claim the pixels and take back their votes -----------------------------------------------
+    for(size_t j : corridor)
+    {
+      if(state[j]==2)
+        vote(j, -1);
+      state[j] = 3;
+    }
+  }
+
+  return segments;
+}
+
+}
@@ -0,0 +1,199 @@
+#include "tp_pipeline_image_utils/functions/JoinSegments.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+//##################################################################################################
+//! End e of segment s is stored as index s*2+e.
+std::array<float, 2> endPoint(const std::vector<LineSegment>& segments, size_t end)
+{
+  const auto& s = segments[end/2];
+  return (end&1)?std::array<float, 2>{s.x1, s.y1}:std::array<float, 2>{s.x0, s.y0};
+}
+
+//##################################################################################################
+struct Joint_lt
+{
+  float distance;
+  size_t a;
+  size_t b;
+
+  bool operator<(const Joint_lt& other) const
+  {
+    if(distance!=other.distance)
+      return distance<other.distance;
+    if(a!=other.a)
+      return a<other.a;
+    return b<other.b;
+  }
+};
+
+//##################################################################################################
+struct EndpointGrid_lt
+{
+  float cellSize{1.0f};
+  std::unordered_map<uint64_t, std::vector<size_t>> cells;
+
+  //################################################################################################
+  static uint64_t key(int64_t cx, int64_t cy)
+  {
+    return (uint64_t(uint32_t(int32_t(cx)))<<32) | uint64_t(uint32_t(int32_t(cy)));
+  }
+
+  //################################################################################################
+  int64_t cell(float v) const
+  {
+    return int64_t(std::floor(v/cellSize));
+  }
+};
+
+//##################################################################################################
+std::array<float, 2> jointPoint(const std::vector<LineSegment>& segments, size_t a, size_t b, float maxJointDistance)
+{
+  auto pa = endPoint(segments, a);
+  auto pb = endPoint(segments, b);
+  std::array<float, 2> mid{(pa[0]+pb[0])*0.5f, (pa[1]+pb[1])*0.5f};
+
+  const auto& sa = segments[a/2];
+  const auto& sb = segments[b/2];
+  double dax = double(sa.x1)-double(sa.x0);
+  double day = double(sa.y1)-double(sa.y0);
+  double dbx = double(sb.x1)-double(sb.x0);
+  double dby = double(sb.y1)-double(sb.y0);
+
+  double denominator = dax*dby - day*dbx;
+  if(std::fabs(denominator)<1e-9)
+    return mid;
+
+  double t = ((double(sb.x0)-double(sa.x0))*dby - (double(sb.y0)-double(sa.y0))*dbx) / denominator;
+  std::array<float, 2> p{float(double(sa.x0)+dax*t), float(double(sa.y0)+day*t)};
+
+  auto distance = [&](const std::array<float, 2>& q)
+  {
+    return std::hypot(p[0]-q[0], p[1]-q[1]);
+  };
+
+  if(distance(pa)>maxJointDistance || distance(pb)>maxJointDistance)
+    return mid;
+
+  return p;
+}
+}
+
+//##################################################################################################
+std::vector<Polyline> joinSegments(const std::vector<LineSegment>& segments, float maxJointDistance)
+{
+  std::vector<Polyline> polylines;
+  size_t endCount = segments.size()*2;
+
+  //-- Index the segment ends ----------------------------------------------------------------------
+  EndpointGrid_lt grid;
+  grid.cellSize = tpMax(1.0f, maxJointDistance);
+  grid.cells.reserve(endCount);
+  for(size_t e=0; e<endCount; e++)
+  {
+    auto p = endPoint(segments, e);
+    grid.cells[EndpointGrid_lt::key(grid.cell(p[0]), grid.cell(p[1]))].push_back(e);
+  }
+
+  //-- Find candidate joints in parallel, ranges are concatenated in order -------------------------
+  std::vector<std::vector<Joint_lt>> rangeJoints(threadCount()+1);
+  parallelFor(endCount, 1024, [&](size_t begin, size_t end, size_t range)
+  {
+    auto& joints = rangeJoints.at(range);
+    for(size_t a=begin; a<end; a++)
+    {
+      auto p = endPoint(segments, a);
+      int64_t cx = grid.cell(p[0]);
+      int64_t cy = grid.cell(p[1]);
+      for(int64_t y=cy-1; y<=cy+1; y++)
+      {
+        for(int64_t x=cx-1; x<=cx+1; x++)
+        {
+          auto i = grid.cells.find(EndpointGrid_lt::key(x, y));
+          if(i==grid.cells.end())
+            continue;
+
+          for(size_t b : i->second)
+          {
+            // Each pair is only recorded once and a segment can't join itself.
+            if(b<=a || b/2==a/2)
+              continue;
+
+            auto q = endPoint(segments, b);
+            float distance = std::hypot(p[0]-q[0], p[1]-q[1]);
+            if(distance<=maxJointDistance)
+              joints.push_back({distance, a, b});
+          }
+        }
+      }
+    }
+  });
+
+  std::vector<Joint_lt> joints;
+  for(auto& r : rangeJoints)
+    joints.insert(joints.end(), r.begin(), r.end());
+  std::sort(joints.begin(), joints.end());
+
+  //-- Accept the closest joints first -------------------------------------------------------------
+  const size_t none = size_t(-1);
+  std::vector<size_t> partner(endCount, none);
+  for(const auto& joint : joints)
+  {
+    if(partner[joint.a]==none && partner[joint.b]==none)
+    {
+      partner[joint.a] = joint.b;
+      partner[joint.b] = joint.a;
+    }
+  }
+
+  //-- Walk the chains -----------------------------------------------------------------------------
+  // Entering a segment at end e we leave through e^1, then cross to the partner of that end.
+  std::vector<bool> visited(segments.size(), false);
+  auto walk = [&](size_t start, bool closed)
+  {
+    Polyline& polyline = polylines.emplace_back();
+    polyline.closed = closed;
+
+    if(!closed)
+      polyline.points.push_back(endPoint(segments, start));
+
+    size_t e = start;
+    for(;;)
+    {
+      visited[e/2] = true;
+      size_t exit = e^1;
+      size_t next = partner[exit];
+      if(next==none)
+      {
+        polyline.points.push_back(endPoint(segments, exit));
+        break;
+      }
+
+      polyline.points.push_back(jointPoint(segments, exit, next, maxJointDistance));
+      if(visited[next/2])
+        break;
+      e = next;
+    }
+  };
+
+  for(size_t s=0; s<segments.size(); s++)
+    if(!visited[s] && (partner[s*2]==none || partner[s*2+1]==none))
+      walk((partner[s*2]==none)?s*2:s*2+1, false);
+
+  // Anything left is part of a loop.
+  for(size_t s=0; s<segments.size(); s++)
+    if(!visited[s])
+      walk(s*2, true);
+
+  return polylines;
+}
+
+}
@@ -0,0 +1,315 @@
+#include "tp_pipeline_image_utils/functions/LocalStatistics.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <vector>
+#include <array>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+//##################################################################################################
+uint8_t clampByte(int v)
+{
+  return uint8_t(tpBound(0, v, 255));
+}
+
+//##################################################################################################
+//! A (w+1)*(h+1) summed area table of src with a row and column of zeros first.
+/*!
+The rows are summed in parallel and then the columns are accumulated in parallel strips.
+*/
+std::vector<uint64_t> integralImage(const tp_image_utils::ByteMap& src)
+{
+  size_t w = src.width();
+  size_t h = src.height();
+  size_t stride = w+1;
+
+  std::vector<uint64_t> integral(stride*(h+1), 0);
+
+  parallelFor(h, 16, [&](size_t yBegin, size_t yEnd, size_t)
+  {
+    for(size_t y=yBegin; y<yEnd; y++)
+    {
+      const uint8_t* s = src.constData() + y*w;
+      uint64_t* row = integral.data() + (y+1)*stride;
+      uint64_t rowSum=0;
+      for(size_t x=0; x<w; x++)
+      {
+        rowSum += s[x];
+        row[x+1] = rowSum;
+      }
+    }
+  });
+
+  parallelFor(stride, 256, [&](size_t xBegin, size_t xEnd, size_t)
+  {
+    for(size_t y=1; y<h; y++)
+    {
+      const uint64_t* above = integral.data() + y*stride;
+      uint64_t* row = integral.data() + (y+1)*stride;
+      for(size_t x=xBegin; x<xEnd; x++)
+        row[x] += above[x];
+    }
+  });
+
+  return integral;
+}
+
+//##################################################################################################
+void localMean(const tp_image_utils::ByteMap& src, size_t radius, tp_image_utils::ByteMap& dst)
+{
+  size_t w = src.width();
+  size_t h = src.height();
+  size_t stride = w+1;
+
+  std::vector<uint64_t> integral = integralImage(src);
+
+  parallelFor(h, 16, [&](size_t yBegin, size_t yEnd, size_t)
+  {
+    for(size_t y=yBegin; y<yEnd; y++)
+    {
+      size_t y0 = (y>radius)?(y-radius):0;
+      size_t y1 = tpMin(h, y+radius+1);
+      const uint64_t* top    = integral.data() + y0*stride;
+      const uint64_t* bottom = integral.data() + y1*stride;
+      uint8_t* d = dst.data() + y*w;
+
+      for(size_t x=0; x<w; x++)
+      {
+        size_t x0 = (x>radius)?(x-radius):0;
+        size_t x1 = tpMin(w, x+radius+1);
+        uint64_t sum = bottom[x1] - bottom[x0] - top[x1] + top[x0];
+        uint64_t count = (x1-x0)*(y1-y0);
+        d[x] = uint8_t((sum + count/2) / count);
+      }
+    }
+  });
+}
+
+//##################################################################################################
+uint8_t histogramStatistic(const std::array<uint32_t, 256>& histogram, uint32_t count, LocalStatistic statistic)
+{
+  switch(statistic)
+  {
+  case LocalStatistic::Median:
+  {
+    uint32_t half = (count+1)/2;
+    uint32_t acc=0;
+    for(size_t i=0; i<256; i++)
+    {
+      acc += histogram[i];
+      if(acc>=half)
+        return uint8_t(i);
+    }
+    return 255;
+  }
+
+  case LocalStatistic::Mode:
+  {
+    size_t best=0;
+    for(size_t i=1; i<256; i++)
+      if(histogram[i]>histogram[best])
+        best=i;
+    return uint8_t(best);
+  }
+
+  case LocalStatistic::SoftMode:
+  {
+    uint32_t window = histogram[0] + histogram[1] + histogram[2];
+    uint32_t bestValue = window;
+    size_t best=0;
+    for(size_t i=1; i<256; i++)
+    {
+      if(i+2<256)
+        window += histogram[i+2];
+      if(i>=3)
+        window -= histogram[i-3];
+
+      if(window>bestValue)
+      {
+        bestValue = window;
+        best = i;
+      }
+    }
+    return uint8_t(best);
+  }
+
+  case LocalStatistic::Mean:
+    break;
+  }
+
+  return 0;
+}
+
+//##################################################################################################
+void localHistogram(const tp_image_utils::ByteMap& src, size_t radius, LocalStatistic statistic, tp_image_utils::ByteMap& dst)
+{
+  size_t w = src.width();
+  size_t h = src.height();
+  const uint8_t* s = src.constData();
+
+  parallelFor(h, tpMax(size_t(16), radius), [&](size_t yBegin, size_t yEnd, size_t)
+  {
+    //-- One histogram per column covering the rows of the current window -------------------------
+    std::vector<uint16_t> columns(w*256, 0);
+    auto addRow = [&](size_t y)
+    {
+      const uint8_t* r = s + y*w;
+      for(size_t x=0; x<w; x++)
+        columns[x*256 + r[x]]++;
+    };
+
+    auto removeRow = [&](size_t y)
+    {
+      const uint8_t* r = s + y*w;
+      for(size_t x=0; x<w; x++)
+        columns[x*256 + r[x]]--;
+    };
+
+    size_t y0 = (yBegin>radius)?(yBegin-radius):0;
+    size_t y1 = tpMin(h, yBegin+radius+1);
+    for(size_t y=y0; y<y1; y++)
+      addRow(y);
+
+    std::array<uint32_t, 256> kernel;
+    for(size_t y=yBegin; y<yEnd; y++)
+    {
+      uint32_t rows = uint32_t(y1-y0);
+
+      //-- Prime the kernel histogram with the columns left of x=0 --------------------------------
+      kernel.fill(0);
+      size_t primed = tpMin(w, radius);
+      for(size_t x=0; x<primed; x++)
+      {
+        const uint16_t* c = columns.data() + x*256;
+        for(size_t i=0; i<256; i++)
+          kernel[i] += c[i];
+      }
+
+      uint8_t* d = dst.data() + y*w;
+      for(size_t x=0; x<w; x++)
+      {
+        if(x+radius<w)
+        {
+          const uint16_t* c = columns.data() + (x+radius)*256;
+          for(size_t i=0; i<256; i++)
+            kernel[i] += c[i];
+        }
+
+        if(x>radius)
+        {
+          const uint16_t* c = columns.data() + (x-radius-1)*256;
+          for(size_t i=0; i<256; i++)
+            kernel[i] -= c[i];
+        }
+
+        size_t x0 = (x>radius)?(x-radius):0;
+        size_t x1 = tpMin(w, x+radius+1);
+        d[x] = histogramStatistic(kernel, rows*uint32_t(x1-x0), statistic);
+      }
+
+      //-- Slide the column histograms down a row ------------------------------------------------
+      if(y+1<yEnd)
+      {
+        size_t n0 = (y+1>radius)?(y+1-radius):0;
+        size_t n1 = tpMin(h, y+1+radius+1);
+        if(n0>y0)
+          removeRow(y0);
+        if(n1>y1)
+          addRow(y1);
+        y0 = n0;
+        y1 = n1;
+      }
+    }
+  });
+}
+}
+
+//##################################################################################################
+tp_image_utils::ByteMap brightness(const tp_image_utils::ColorMap& src)
+{
+  tp_image_utils::ByteMap dst;
+  dst.setSize(src.width(), src.height());
+
+  const TPPixel* s = src.constData();
+  uint8_t* d = dst.data();
+  parallelFor(src.size(), 1<<16, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t i=begin; i<end; i++)
+      d[i] = uint8_t((int(s[i].r) + int(s[i].g) + int(s[i].b)) / 3);
+  });
+
+  return dst;
+}
+
+//##################################################################################################
+tp_image_utils::ByteMap localStatistic(const tp_image_utils::ByteMap& src, size_t radius, LocalStatistic statistic)
+{
+  tp_image_utils::ByteMap dst;
+  dst.setSize(src.width(), src.height());
+
+  if(src.size()<1)
+    return dst;
+
+  if(statistic == LocalStatistic::Mean)
+    localMean(src, radius, dst);
+  else
+    localHistogram(src, radius, statistic, dst);
+
+  return dst;
+}
+
+//##################################################################################################
+void normalizeBrightnessLocal(tp_image_utils::ColorMap& image, size_t radius, float exaggeration)
+{
+  tp_image_utils::ByteMap mean = localStatistic(brightness(image), radius, LocalStatistic::Mean);
+
+  TPPixel* p = image.data();
+  const uint8_t* m = mean.constData();
+
+  parallelFor(image.size(), 1<<16, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t i=begin; i<end; i++)
+    {
+      int avg = m[i];
+      TPPixel& px = p[i];
+      if(exaggeration>0.0f)
+      {
+        px.r = clampByte(avg + int(float(int(px.r)-avg)*exaggeration));
+        px.g = clampByte(avg + int(float(int(px.g)-avg)*exaggeration));
+        px.b = clampByte(avg + int(float(int(px.b)-avg)*exaggeration));
+      }
+      else
+      {
+        px.r = clampByte(int(px.r) - avg + 128);
+        px.g = clampByte(int(px.g) - avg + 128);
+        px.b = clampByte(int(px.b) - avg + 128);
+      }
+    }
+  });
+}
+
+//##################################################################################################
+void shiftBrightnessLocal(tp_image_utils::ColorMap& image, size_t radius, LocalStatistic statistic, uint8_t target)
+{
+  tp_image_utils::ByteMap stat = localStatistic(brightness(image), radius, statistic);
+
+  TPPixel* p = image.data();
+  const uint8_t* s = stat.constData();
+
+  parallelFor(image.size(), 1<<16, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t i=begin; i<end; i++)
+    {
+      int offset = int(target) - int(s[i]);
+      TPPixel& px = p[i];
+      px.r = clampByte(int(px.r) + offset);
+      px.g = clampByte(int(px.g) + offset);
+      px.b = clampByte(int(px.b) + offset);
+    }
+  });
+}
+
+}
@@ -0,0 +1,177 @@
+#include "tp_pipeline_image_utils/functions/Palette.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <array>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+constexpr size_t levels = 16;
+constexpr size_t binCount = levels*levels*levels*levels;
+
+//##################################################################################################
+struct Bin_lt
+{
+  uint64_t count{0};
+  uint64_t sum[4]{0, 0, 0, 0};
+};
+
+//##################################################################################################
+struct Box_lt
+{
+  std::array<size_t, 4> lo{{0, 0, 0, 0}};
+  std::array<size_t, 4> hi{{levels-1, levels-1, levels-1, levels-1}};
+  uint64_t count{0};
+};
+
+//##################################################################################################
+size_t binIndex(TPPixel p)
+{
+  return size_t(p.r>>4) | (size_t(p.g>>4)<<4) | (size_t(p.b>>4)<<8) | (size_t(p.a>>4)<<12);
+}
+
+//##################################################################################################
+template<typename T>
+void forEachBin(const Box_lt& box, T closure)
+{
+  for(size_t a=box.lo[3]; a<=box.hi[3]; a++)
+    for(size_t b=box.lo[2]; b<=box.hi[2]; b++)
+      for(size_t g=box.lo[1]; g<=box.hi[1]; g++)
+        for(size_t r=box.lo[0]; r<=box.hi[0]; r++)
+          closure(r | (g<<4) | (b<<8) | (a<<12), std::array<size_t, 4>{{r, g, b, a}});
+}
+
+//##################################################################################################
+//! Shrink the box to the bins that hold pixels and count them.
+void shrink(const std::vector<Bin_lt>& bins, Box_lt& box)
+{
+  Box_lt result;
+  result.lo = box.hi;
+  result.hi = box.lo;
+  forEachBin(box, [&](size_t i, const std::array<size_t, 4>& c)
+  {
+    if(bins[i].count==0)
+      return;
+
+    result.count += bins[i].count;
+    for(size_t n=0; n<4; n++)
+    {
+      result.lo[n] = tpMin(result.lo[n], c[n]);
+      result.hi[n] = tpMax(result.hi[n], c[n]);
+    }
+  });
+  box = result;
+}
+
+//##################################################################################################
+//! Split the box across its longest channel so that each half holds about half the pixels.
+Box_lt split(const std::vector<Bin_lt>& bins, Box_lt& box)
+{
+  size_t channel=0;
+  for(size_t n=1; n<4; n++)
+    if(box.hi[n]-box.lo[n] > box.hi[channel]-box.lo[channel])
+      channel = n;
+
+  std::array<uint64_t, levels> slices{};
+  forEachBin(box, [&](size_t i, const std::array<size_t, 4>& c)
+  {
+    slices[c[channel]] += bins[i].count;
+  });
+
+  size_t at = box.lo[channel];
+  uint64_t sum = slices[at];
+  while(at+1<box.hi[channel] && sum*2<box.count)
+  {
+    at++;
+    sum += slices[at];
+  }
+
+  Box_lt upper = box;
+  box.hi[channel] = at;
+  upper.lo[channel] = at+1;
+  shrink(bins, box);
+  shrink(bins, upper);
+  return upper;
+}
+}
+
+//##################################################################################################
+bool quantizeColors(const tp_image_utils::ColorMap& src,
+                    size_t paletteSize,
+                    tp_image_utils::ByteMap& indices,
+                    std::vector<TPPixel>& palette)
+{
+  palette.clear();
+  if(paletteSize<1 || paletteSize>256)
+    return false;
+
+  size_t w = src.width();
+  size_t h = src.height();
+  indices.setSize(w, h);
+  if(src.size()<1)
+    return true;
+
+  std::vector<Bin_lt> bins(binCount);
+  {
+    const TPPixel* s = src.constData();
+    const TPPixel* sMax = s + src.size();
+    for(; s<sMax; s++)
+    {
+      Bin_lt& bin = bins[binIndex(*s)];
+      bin.count++;
+      bin.sum[0] += s->r;
+      bin.sum[1] += s->g;
+      bin.sum[2] += s->b;
+      bin.sum[3] += s->a;
+    }
+  }
+
+  std::vector<Box_lt> boxes(1);
+  shrink(bins, boxes.front());
+
+  while(boxes.size()<paletteSize)
+  {
+    // Split the most populated box that covers more than one bin.
+    Box_lt* largest=nullptr;
+    for(auto& box : boxes)
+      if(box.lo!=box.hi && (!largest || box.count>largest->count))
+        largest = &box;
+
+    if(!largest)
+      break;
+
+    Box_lt upper = split(bins, *largest);
+    boxes.push_back(upper);
+  }
+
+  std::vector<uint8_t> lookup(binCount, 0);
+  for(size_t b=0; b<boxes.size(); b++)
+  {
+    uint64_t sum[4]{0, 0, 0, 0};
+    forEachBin(boxes.at(b), [&](size_t i, const std::array<size_t, 4>&)
+    {
+      lookup[i] = uint8_t(b);
+      for(size_t n=0; n<4; n++)
+        sum[n] += bins[i].sum[n];
+    });
+
+    uint64_t count = boxes.at(b).count;
+    auto mean = [&](size_t n){return uint8_t((sum[n] + count/2) / count);};
+    palette.emplace_back(mean(0), mean(1), mean(2), mean(3));
+  }
+
+  parallelFor(h, 16, [&](size_t yBegin, size_t yEnd, size_t)
+  {
+    const TPPixel* s = src.constData() + yBegin*w;
+    const TPPixel* sMax = src.constData() + yEnd*w;
+    uint8_t* d = indices.data() + yBegin*w;
+    for(; s<sMax; s++, d++)
+      (*d) = lookup[binIndex(*s)];
+  });
+
+  return true;
+}
+
+}
@@ -0,0 +1,315 @@
+#include "tp_pipeline_image_utils/functions/PixelGrid.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+constexpr double pi = 3.14159265358979323846;
+
+//##################################################################################################
+//! In place iterative radix 2 FFT, the size of data must be a power of 2.
+void fft(std::vector<std::complex<double>>& data, bool inverse)
+{
+  size_t n = data.size();
+
+  for(size_t i=1, j=0; i<n; i++)
+  {
+    size_t bit = n>>1;
+    for(; j&bit; bit>>=1)
+      j ^= bit;
+    j ^= bit;
+    if(i<j)
+      std::swap(data[i], data[j]);
+  }
+
+  for(size_t length=2; length<=n; length<<=1)
+  {
+    double angle = 2.0*pi/double(length) * (inverse?1.0:-1.0);
+    std::complex<double> step(std::cos(angle), std::sin(angle));
+    for(size_t i=0; i<n; i+=length)
+    {
+      std::complex<double> w(1.0, 0.0);
+      for(size_t k=0; k<length/2; k++)
+      {
+        auto u = data[i+k];
+        auto v = data[i+k+length/2]*w;
+        data[i+k] = u+v;
+        data[i+k+length/2] = u-v;
+        w *= step;
+      }
+    }
+  }
+
+  if(inverse)
+    for(auto& v : data)
+      v /= double(n);
+}
+
+//##################################################################################################
+//! The profile value at index i is the edge strength between pixel i-1 and pixel i.
+PixelGridAxis estimateAxis(const std::vector<uint64_t>& profile, size_t imageSize, size_t minPeriod)
+{
+  PixelGridAxis axis;
+  axis.cells = imageSize;
+
+  size_t n = profile.size();
+  size_t maxPeriod = n/3;
+  minPeriod = tpMax(size_t(2), minPeriod);
+  if(n<4 || maxPeriod<=minPeriod)
+    return axis;
+
+  double mean=0.0;
+  for(auto v : profile)
+    mean += double(v);
+  mean /= double(n);
+
+  //-- Spectrum and autocorrelation ---------------------------------------------------------------
+  // The profile is padded well past the 2n needed to avoid wrap around in the autocorrelation so
+  // that the spectrum is finely sampled, bin k is the Fourier component at a period of size/k.
+  size_t size=1;
+  while(size<n*8)
+    size<<=1;
+
+  std::vector<std::complex<double>> spectrum(size, 0.0);
+  for(size_t i=0; i<n; i++)
+    spectrum[i] = double(profile[i])-mean;
+  fft(spectrum, false);
+
+  std::vector<std::complex<double>> data(size);
+  for(size_t i=0; i<size; i++)
+    data[i] = std::norm(spectrum[i]);
+  fft(data, true);
+
+  // Normalize by the overlap so that long lags are not penalized.
+  auto correlation = [&](size_t lag)
+  {
+    return data[lag].real() / double(n-lag);
+  };
+
+  double best=0.0;
+  for(size_t lag=minPeriod; lag<=maxPeriod; lag++)
+    best = tpMax(best, correlation(lag));
+
+  if(best<=0.0)
+    return axis;
+
+  //-- The first local maximum close to the best is the period, later ones are its multiples -------
+  size_t lag=0;
+  for(size_t l=minPeriod; l<=maxPeriod; l++)
+  {
+    double c = correlation(l);
+    if(c>=0.8*best && c>=correlation(l-1) && c>=correlation(l+1))
+    {
+      lag = l;
+      break;
+    }
+  }
+
+  if(!lag)
+    return axis;
+
+  //-- Refine to a fraction of a pixel ------------------------------------------------------------
+  // The lag may be a whole multiple of a fractional period, for example 13 for cells 6.5 pixels
+  // wide. The Fourier component of a train of edges is only strong at its period and at whole
+  // fractions of it, so the first strong divisor of the lag is the period.
+  auto bestBin = [&](double lo, double hi)
+  {
+    auto kBegin = size_t(std::ceil (double(size)/hi));
+    auto kEnd   = size_t(std::floor(double(size)/lo));
+    kEnd = tpMin(kEnd, size/2-1);
+    size_t best=kBegin;
+    for(size_t k=kBegin; k<=kEnd; k++)
+      if(std::abs(spectrum[k])>std::abs(spectrum[best]))
+        best = k;
+    return best;
+  };
+
+  size_t maxDivisor = tpMin(size_t(16), lag/minPeriod);
+  std::vector<size_t> bins(maxDivisor+1, 0);
+  double bestMagnitude=0.0;
+  for(size_t d=1; d<=maxDivisor; d++)
+  {
+    double lo = tpMax(double(minPeriod), (double(lag)-0.5)/double(d));
+    double hi = (double(lag)+0.5)/double(d);
+    bins[d] = bestBin(lo, hi);
+    bestMagnitude = tpMax(bestMagnitude, std::abs(spectrum[bins[d]]));
+  }
+
+  size_t bin = size_t(std::lround(double(size)/double(lag)));
+  for(size_t d=1; d<=maxDivisor; d++)
+  {
+    if(std::abs(spectrum[bins[d]])>=0.5*bestMagnitude)
+    {
+      bin = bins[d];
+      break;
+    }
+  }
+
+  double frequency = double(bin);
+  if(bin>0 && bin+1<size)
+  {
+    double a = std::abs(spectrum[bin-1]);
+    double b = std::abs(spectrum[bin]);
+    double c = std::abs(spectrum[bin+1]);
+    double denominator = a - 2.0*b + c;
+    if(std::fabs(denominator)>1e-12)
+      frequency += tpBound(-0.5, 0.5*(a-c)/denominator, 0.5);
+  }
+  double period = double(size)/frequency;
+
+  //-- Phase of the profile at the period gives the position of the cell edges --------------------
+  std::complex<double> sum(0.0, 0.0);
+  for(size_t i=0; i<n; i++)
+  {
+    double a = -2.0*pi*double(i)/period;
+    sum += (double(profile[i])-mean) * std::complex<double>(std::cos(a), std::sin(a));
+  }
+
+  double offset = -std::arg(sum)*period/(2.0*pi);
+  offset = std::fmod(offset, period);
+  if(offset<0.0)
+    offset += period;
+
+  // Leading slivers less than half a pixel wide are merged into the first whole cell.
+  if(offset>0.5)
+    offset -= period;
+
+  axis.period = period;
+  axis.start = offset;
+  axis.cells = size_t(std::ceil((double(imageSize)-offset)/period));
+  return axis;
+}
+
+//##################################################################################################
+//! The middle half of cell i along an axis, clipped to the image.
+void cellRange(const PixelGridAxis& axis, size_t i, size_t imageSize, size_t& begin, size_t& end)
+{
+  double cellBegin = axis.start + double(i)*axis.period;
+  double quarter = axis.period*0.25;
+  auto b = int64_t(std::floor(cellBegin+quarter+0.5));
+  auto e = int64_t(std::floor(cellBegin+axis.period-quarter+0.5));
+  b = tpBound(int64_t(0), b, int64_t(imageSize)-1);
+  e = tpBound(b+1, e, int64_t(imageSize));
+  begin = size_t(b);
+  end = size_t(e);
+}
+
+//##################################################################################################
+template<typename T, typename Sum, typename Add, typename Make>
+void sample(const T* src, size_t w, size_t h, const PixelGridEstimate& grid, T* dst, Sum zero, Add add, Make make)
+{
+  parallelFor(grid.y.cells, 4, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t cy=begin; cy<end; cy++)
+    {
+      size_t y0, y1;
+      cellRange(grid.y, cy, h, y0, y1);
+      for(size_t cx=0; cx<grid.x.cells; cx++)
+      {
+        size_t x0, x1;
+        cellRange(grid.x, cx, w, x0, x1);
+        auto sum = zero;
+        for(size_t y=y0; y<y1; y++)
+          for(size_t x=x0; x<x1; x++)
+            add(sum, src[y*w+x]);
+        dst[cy*grid.x.cells + cx] = make(sum, (x1-x0)*(y1-y0));
+      }
+    }
+  });
+}
+}
+
+//##################################################################################################
+PixelGridEstimate estimatePixelGrid(const tp_image_utils::ByteMap& src, size_t minPeriod)
+{
+  size_t w = src.width();
+  size_t h = src.height();
+
+  PixelGridEstimate grid;
+  grid.x.cells = w;
+  grid.y.cells = h;
+  if(w<2 || h<2)
+    return grid;
+
+  const uint8_t* s = src.constData();
+
+  //-- Row profile, each row is independent --------------------------------------------------------
+  std::vector<uint64_t> rowProfile(h, 0);
+  parallelFor(h-1, 16, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t y=begin+1; y<end+1; y++)
+    {
+      const uint8_t* above = s + (y-1)*w;
+      const uint8_t* row = s + y*w;
+      uint64_t sum=0;
+      for(size_t x=0; x<w; x++)
+        sum += uint64_t(std::abs(int(row[x]) - int(above[x])));
+      rowProfile[y] = sum;
+    }
+  });
+
+  //-- Column profile, each band sums into its own array and they are added at the end -------------
+  std::vector<std::vector<uint64_t>> bandProfiles(threadCount()+1);
+  parallelFor(h, 16, [&](size_t begin, size_t end, size_t range)
+  {
+    auto& profile = bandProfiles.at(range);
+    profile.assign(w, 0);
+    for(size_t y=begin; y<end; y++)
+    {
+      const uint8_t* row = s + y*w;
+      for(size_t x=1; x<w; x++)
+        profile[x] += uint64_t(std::abs(int(row[x]) - int(row[x-1])));
+    }
+  });
+
+  std::vector<uint64_t> columnProfile(w, 0);
+  for(const auto& profile : bandProfiles)
+    for(size_t x=0; x<profile.size(); x++)
+      columnProfile[x] += profile[x];
+
+  grid.x = estimateAxis(columnProfile, w, minPeriod);
+  grid.y = estimateAxis(rowProfile, h, minPeriod);
+  return grid;
+}
+
+//##################################################################################################
+tp_image_utils::ByteMap samplePixelGrid(const tp_image_utils::ByteMap& src, const PixelGridEstimate& grid)
+{
+  tp_image_utils::ByteMap dst;
+  dst.setSize(grid.x.cells, grid.y.cells);
+  if(src.size()<1 || dst.size()<1)
+    return dst;
+
+  sample(src.constData(), src.width(), src.height(), grid, dst.data(), uint64_t(0),
+         [](uint64_t& sum, uint8_t v){sum += v;},
+         [](uint64_t sum, size_t count){return uint8_t((sum + count/2) / count);});
+  return dst;
+}
+
+//##################################################################################################
+tp_image_utils::ColorMap samplePixelGrid(const tp_image_utils::ColorMap& src, const PixelGridEstimate& grid)
+{
+  tp_image_utils::ColorMap dst;
+  dst.setSize(grid.x.cells, grid.y.cells);
+  if(src.size()<1 || dst.size()<1)
+    return dst;
+
+  using Sum = std::array<uint64_t, 4>;
+  sample(src.constData(), src.width(), src.height(), grid, dst.data(), Sum{0, 0, 0, 0},
+         [](Sum& sum, const TPPixel& p){sum[0]+=p.r; sum[1]+=p.g; sum[2]+=p.b; sum[3]+=p.a;},
+         [](const Sum& sum, size_t count)
+  {
+    auto c = [&](size_t i){return uint8_t((sum[i] + count/2) / count);};
+    return TPPixel(c(0), c(1), c(2), c(3));
+  });
+  return dst;
+}
+
+}
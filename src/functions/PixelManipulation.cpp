@@ -0,0 +1,300 @@
+#include "tp_pipeline_image_utils/functions/PixelManipulation.h"
+#include "tp_pipeline_image_utils/functions/Expression.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <algorithm>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+constexpr size_t lanes = CompiledExpression::lanes;
+
+//##################################################################################################
+enum class Channel_lt
+{
+  Red,
+  Green,
+  Blue,
+  Alpha,
+  Byte,
+  X,
+  Y
+};
+
+constexpr size_t channelCount = 7;
+
+//##################################################################################################
+//! A channel of one of the inputs.
+struct Binding_lt
+{
+  size_t input;
+  Channel_lt channel;
+
+  size_t slot() const {return input*channelCount + size_t(channel);}
+};
+
+//##################################################################################################
+size_t width(const PixelInput& input)
+{
+  return input.color?input.color->width():input.byte->width();
+}
+
+//##################################################################################################
+size_t height(const PixelInput& input)
+{
+  return input.color?input.color->height():input.byte->height();
+}
+
+//##################################################################################################
+bool channelFromString(const std::string& name, Channel_lt& channel)
+{
+  if(name=="red"   ){channel = Channel_lt::Red  ; return true;}
+  if(name=="green" ){channel = Channel_lt::Green; return true;}
+  if(name=="blue"  ){channel = Channel_lt::Blue ; return true;}
+  if(name=="alpha" ){channel = Channel_lt::Alpha; return true;}
+  if(name=="byte"  ){channel = Channel_lt::Byte ; return true;}
+  if(name=="x"     ){channel = Channel_lt::X    ; return true;}
+  if(name=="y"     ){channel = Channel_lt::Y    ; return true;}
+  return false;
+}
+
+//##################################################################################################
+//! Load lanes values of a channel starting at (x, y), pixels past the end of the row repeat the last one.
+void loadChannel(const PixelInput& source, Channel_lt channel, size_t x, size_t y, float* dst)
+{
+  size_t w = width(source);
+  size_t row = y*w;
+
+  for(size_t l=0; l<lanes; l++)
+  {
+    size_t px = tpMin(x+l, w-1);
+    float v=0.0f;
+    switch(channel)
+    {
+    case Channel_lt::X: v = float(x+l); break;
+    case Channel_lt::Y: v = float(y);   break;
+    default:
+      if(source.color)
+      {
+        const TPPixel& p = source.color->constData()[row+px];
+        switch(channel)
+        {
+        case Channel_lt::Red:   v = float(p.r); break;
+        case Channel_lt::Green: v = float(p.g); break;
+        case Channel_lt::Blue:  v = float(p.b); break;
+        case Channel_lt::Alpha: v = float(p.a); break;
+        default:                v = float(int(p.r)+int(p.g)+int(p.b))/3.0f; break;
+        }
+      }
+      else
+        v = (channel==Channel_lt::Alpha)?255.0f:float(source.byte->constData()[row+px]);
+      break;
+    }
+    dst[l] = v;
+  }
+}
+
+//##################################################################################################
+uint8_t toByte(float v)
+{
+  // Written so that NaN becomes 0.
+  if(!(v>0.0f))
+    return 0;
+  if(v>=255.0f)
+    return 255;
+  return uint8_t(v+0.5f);
+}
+
+//##################################################################################################
+//! Compile the expressions and bind their variables to channels of the inputs.
+bool compile(const std::vector<PixelInput>& inputs,
+             const std::vector<const std::string*>& texts,
+             std::vector<std::shared_ptr<const CompiledExpression>>& programs,
+             std::vector<std::vector<Binding_lt>>& bindings,
+             std::vector<std::string>& errors)
+{
+  if(inputs.empty())
+  {
+    errors.push_back("No input images.");
+    return false;
+  }
+
+  for(const auto& input : inputs)
+  {
+    if(!input.color && !input.byte)
+    {
+      errors.push_back("Failed to find input image " + input.alias + ".");
+      return false;
+    }
+
+    if(width(input)!=width(inputs.front()) || height(input)!=height(inputs.front()))
+    {
+      errors.push_back("Input image " + input.alias + " is a different size.");
+      return false;
+    }
+  }
+
+  bool ok=true;
+  for(const auto text : texts)
+  {
+    std::string error;
+    auto program = CompiledExpression::compile(*text, error);
+    if(!program)
+    {
+      errors.push_back(error);
+      ok=false;
+      continue;
+    }
+
+    std::vector<Binding_lt> binding;
+    for(const auto& variable : program->variables())
+    {
+      std::string alias;
+      std::string channelName = variable;
+      if(auto dot = variable.rfind('.'); dot!=std::string::npos)
+      {
+        alias = variable.substr(0, dot);
+        channelName = variable.substr(dot+1);
+      }
+
+      Binding_lt b{0, Channel_lt::Byte};
+      bool known = channelFromString(channelName, b.channel);
+
+      // Coordinates don't read an image so they don't need an input with an empty alias.
+      bool coordinate = alias.empty() && (b.channel==Channel_lt::X || b.channel==Channel_lt::Y);
+      if(known && !coordinate)
+      {
+        auto i = std::find_if(inputs.begin(), inputs.end(), [&](const PixelInput& input){return input.alias==alias;});
+        known = (i!=inputs.end());
+        b.input = size_t(i-inputs.begin());
+      }
+
+      if(!known)
+      {
+        errors.push_back("Unknown variable " + variable + " in: " + *text);
+        ok=false;
+      }
+
+      binding.push_back(b);
+    }
+
+    programs.push_back(program);
+    bindings.push_back(binding);
+  }
+  return ok;
+}
+
+//##################################################################################################
+//! Evaluate each program over the source, write(i, p, count, values) stores count results of program p at pixel i.
+template<typename Write>
+void evaluate(const std::vector<PixelInput>& inputs,
+              const std::vector<std::shared_ptr<const CompiledExpression>>& programs,
+              const std::vector<std::vector<Binding_lt>>& bindings,
+              const Write& write)
+{
+  size_t w = width(inputs.front());
+  size_t h = height(inputs.front());
+  size_t slots = inputs.size()*channelCount;
+  if(w<1 || h<1)
+    return;
+
+  size_t scratchSize=0;
+  for(const auto& program : programs)
+    scratchSize = tpMax(scratchSize, program->scratchSize());
+
+  parallelFor(h, 8, [&](size_t begin, size_t end, size_t)
+  {
+    std::vector<float> scratch(scratchSize);
+    std::vector<float> channels(slots*lanes);
+    std::vector<uint8_t> loaded(slots);
+    std::vector<const float*> registers;
+    float result[lanes];
+
+    for(size_t y=begin; y<end; y++)
+    {
+      for(size_t x=0; x<w; x+=lanes)
+      {
+        size_t count = tpMin(lanes, w-x);
+
+        std::fill(loaded.begin(), loaded.end(), 0);
+        for(size_t p=0; p<programs.size(); p++)
+        {
+          registers.clear();
+          for(const auto& binding : bindings.at(p))
+          {
+            size_t slot = binding.slot();
+            if(!loaded[slot])
+            {
+              loadChannel(inputs.at(binding.input), binding.channel, x, y, channels.data()+slot*lanes);
+              loaded[slot] = 1;
+            }
+            registers.push_back(channels.data()+slot*lanes);
+          }
+
+          programs.at(p)->run(registers.data(), scratch.data(), result);
+          write(y*w+x, p, count, result);
+        }
+      }
+    }
+  });
+}
+}
+
+//##################################################################################################
+tp_image_utils::ColorMap compiledPixelManipulationColor(const std::vector<PixelInput>& inputs,
+                                                        const PixelExpressions& expressions,
+                                                        std::vector<std::string>& errors)
+{
+  tp_image_utils::ColorMap dst;
+
+  std::vector<std::shared_ptr<const CompiledExpression>> programs;
+  std::vector<std::vector<Binding_lt>> bindings;
+  if(!compile(inputs, {&expressions.calcRed, &expressions.calcGreen, &expressions.calcBlue, &expressions.calcAlpha}, programs, bindings, errors))
+    return dst;
+
+  dst.setSize(width(inputs.front()), height(inputs.front()));
+  TPPixel* d = dst.data();
+  evaluate(inputs, programs, bindings, [&](size_t i, size_t p, size_t count, const float* values)
+  {
+    for(size_t l=0; l<count; l++)
+    {
+      TPPixel& pixel = d[i+l];
+      switch(p)
+      {
+      case 0: pixel.r = toByte(values[l]); break;
+      case 1: pixel.g = toByte(values[l]); break;
+      case 2: pixel.b = toByte(values[l]); break;
+      default:pixel.a = toByte(values[l]); break;
+      }
+    }
+  });
+
+  return dst;
+}
+
+//##################################################################################################
+tp_image_utils::ByteMap compiledPixelManipulationByte(const std::vector<PixelInput>& inputs,
+                                                      const PixelExpressions& expressions,
+                                                      std::vector<std::string>& errors)
+{
+  tp_image_utils::ByteMap dst;
+
+  std::vector<std::shared_ptr<const CompiledExpression>> programs;
+  std::vector<std::vector<Binding_lt>> bindings;
+  if(!compile(inputs, {&expressions.calcByte}, programs, bindings, errors))
+    return dst;
+
+  dst.setSize(width(inputs.front()), height(inputs.front()));
+  uint8_t* d = dst.data();
+  evaluate(inputs, programs, bindings, [&](size_t i, size_t, size_t count, const float* values)
+  {
+    for(size_t l=0; l<count; l++)
+      d[i+l] = toByte(values[l]);
+  });
+
+  return dst;
+}
+
+}
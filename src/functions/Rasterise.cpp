@@ -0,0 +1,206 @@
+#include "tp_pipeline_image_utils/functions/Rasterise.h"
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tp_pipeline_image_utils
+{
+
+namespace
+{
+constexpr size_t bandHeight = 32;
+}
+
+//##################################################################################################
+void LineBatch::addLine(float x0, float y0, float x1, float y1, TPPixel color, float width)
+{
+  m_lines.push_back({x0, y0, x1, y1, color, tpMax(0.5f, width*0.5f)});
+}
+
+//##################################################################################################
+void LineBatch::addLine(const tp_image_utils::Line& line, TPPixel color, float width)
+{
+  if(line.size()==1)
+    addLine(line.front().x, line.front().y, line.front().x, line.front().y, color, width);
+
+  for(size_t i=1; i<line.size(); i++)
+    addLine(line[i-1].x, line[i-1].y, line[i].x, line[i].y, color, width);
+}
+
+//##################################################################################################
+void LineBatch::addLines(const tp_image_utils::LineCollection& lines, TPPixel color, float width)
+{
+  for(const auto& line : lines)
+    addLine(line, color, width);
+}
+
+//##################################################################################################
+void LineBatch::addGrid(const tp_image_utils::Grid& grid, size_t imageWidth, size_t imageHeight, TPPixel color, float width)
+{
+  double ox = double(grid.origin.x);
+  double oy = double(grid.origin.y);
+  double ax = double(grid.xAxis.x);
+  double ay = double(grid.xAxis.y);
+  double bx = double(grid.yAxis.x);
+  double by = double(grid.yAxis.y);
+
+  int64_t xBegin=0;
+  int64_t xEnd=int64_t(grid.xCells);
+  int64_t yBegin=0;
+  int64_t yEnd=int64_t(grid.yCells);
+
+  if(grid.type == tp_image_utils::GridTypeInfinite)
+  {
+    // Find the range of grid coordinates that the image corners map to.
+    double determinant = ax*by - ay*bx;
+    if(std::fabs(determinant)<1e-9)
+      return;
+
+    double uMin=0.0, uMax=0.0, vMin=0.0, vMax=0.0;
+    bool first=true;
+    for(double x : {0.0, double(imageWidth)})
+    {
+      for(double y : {0.0, double(imageHeight)})
+      {
+        double px = x-ox;
+        double py = y-oy;
+        double u = (px*by - py*bx) / determinant;
+        double v = (ax*py - ay*px) / determinant;
+        if(first || u<uMin) uMin = u;
+        if(first || u>uMax) uMax = u;
+        if(first || v<vMin) vMin = v;
+        if(first || v>vMax) vMax = v;
+        first=false;
+      }
+    }
+
+    // Guard against degenerate axes that would need millions of lines.
+    if(uMax-uMin>1e5 || vMax-vMin>1e5)
+      return;
+
+    xBegin = int64_t(std::floor(uMin));
+    xEnd   = int64_t(std::ceil (uMax));
+    yBegin = int64_t(std::floor(vMin));
+    yEnd   = int64_t(std::ceil (vMax));
+  }
+
+  auto point = [&](int64_t u, int64_t v, float& x, float& y)
+  {
+    x = float(ox + double(u)*ax + double(v)*bx);
+    y = float(oy + double(u)*ay + double(v)*by);
+  };
+
+  float x0, y0, x1, y1;
+  for(int64_t u=xBegin; u<=xEnd; u++)
+  {
+    point(u, yBegin, x0, y0);
+    point(u, yEnd, x1, y1);
+    addLine(x0, y0, x1, y1, color, width);
+  }
+
+  for(int64_t v=yBegin; v<=yEnd; v++)
+  {
+    point(xBegin, v, x0, y0);
+    point(xEnd, v, x1, y1);
+    addLine(x0, y0, x1, y1, color, width);
+  }
+}
+
+//##################################################################################################
+bool LineBatch::empty() const
+{
+  return m_lines.empty();
+}
+
+//##################################################################################################
+void LineBatch::draw(tp_image_utils::ColorMap& dst) const
+{
+  size_t w = dst.width();
+  size_t h = dst.height();
+  if(w<1 || h<1 || m_lines.empty())
+    return;
+
+  //-- Bin the lines by band -----------------------------------------------------------------------
+  size_t bandCount = (h+bandHeight-1)/bandHeight;
+  std::vector<std::vector<size_t>> bands(bandCount);
+  for(size_t i=0; i<m_lines.size(); i++)
+  {
+    const auto& l = m_lines[i];
+    double r = double(l.halfWidth)+1.0;
+    double yMin = double(tpMin(l.y0, l.y1))-r;
+    double yMax = double(tpMax(l.y0, l.y1))+r;
+    if(!(yMax>=0.0 && yMin<double(h)) || !std::isfinite(yMin) || !std::isfinite(yMax))
+      continue;
+
+    size_t first = size_t(tpMax(0.0, yMin))/bandHeight;
+    size_t last  = tpMin(bandCount-1, size_t(tpMin(double(h-1), yMax))/bandHeight);
+    for(size_t b=first; b<=last; b++)
+      bands[b].push_back(i);
+  }
+
+  //-- Render the bands in parallel ----------------------------------------------------------------
+  TPPixel* pixels = dst.data();
+  parallelFor(bandCount, 1, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t b=begin; b<end; b++)
+    {
+      size_t rowBegin = b*bandHeight;
+      size_t rowEnd = tpMin(h, rowBegin+bandHeight);
+
+      for(size_t i : bands[b])
+      {
+        const auto& l = m_lines[i];
+        double x0 = double(l.x0);
+        double y0 = double(l.y0);
+        double dx = double(l.x1)-x0;
+        double dy = double(l.y1)-y0;
+        double lengthSquared = dx*dx + dy*dy;
+        double r = double(l.halfWidth);
+        double rSquared = r*r;
+
+        double lineYMin = tpMin(y0, y0+dy)-r;
+        double lineYMax = tpMax(y0, y0+dy)+r;
+        auto yFirst = size_t(tpMax(double(rowBegin), std::ceil (lineYMin)));
+        auto yLast  = int64_t(tpMin(double(rowEnd)-1.0, std::floor(lineYMax)));
+
+        for(auto y=int64_t(yFirst); y<=yLast; y++)
+        {
+          //-- Clip the segment to the rows within r of this one to find the span -----------------
+          double tMin=0.0;
+          double tMax=1.0;
+          if(std::fabs(dy)>1e-9)
+          {
+            double ta = (double(y)-r-y0)/dy;
+            double tb = (double(y)+r-y0)/dy;
+            tMin = tpMax(0.0, tpMin(ta, tb));
+            tMax = tpMin(1.0, tpMax(ta, tb));
+            if(tMin>tMax)
+              continue;
+          }
+
+          double xa = x0+dx*tMin;
+          double xb = x0+dx*tMax;
+          auto xFirst = int64_t(std::ceil (tpMin(xa, xb)-r));
+          auto xLast  = int64_t(std::floor(tpMax(xa, xb)+r));
+          xFirst = tpMax(int64_t(0), xFirst);
+          xLast  = tpMin(int64_t(w)-1, xLast);
+
+          TPPixel* row = pixels + size_t(y)*w;
+          for(int64_t x=xFirst; x<=xLast; x++)
+          {
+            double px = double(x)-x0;
+            double py = double(y)-y0;
+            double t = (lengthSquared>0.0)?tpBound(0.0, (px*dx + py*dy)/lengthSquared, 1.0):0.0;
+            double ex = px - dx*t;
+            double ey = py - dy*t;
+            if(ex*ex + ey*ey <= rSquared)
+              row[x] = l.color;
+          }
+        }
+      }
+    }
+  });
+}
+
+}
@@ -0,0 +1,19 @@
+#include "tp_pipeline_image_utils/members/FloatMapMember.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+FloatMapMember::FloatMapMember(const std::string& name):
+  tp_data::AbstractMember(name)
+{
+
+}
+
+//##################################################################################################
+void FloatMapMember::copyData(const tp_data::AbstractMember& other)
+{
+  data = dynamic_cast<const FloatMapMember&>(other).data;
+}
+
+}
@@ -0,0 +1,41 @@
+#include "tp_pipeline_image_utils/members/IndexedImageMember.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+IndexedImageMember::IndexedImageMember(const std::string& name):
+  tp_data::AbstractMember(name)
+{
+
+}
+
+//##################################################################################################
+void IndexedImageMember::copyData(const tp_data::AbstractMember& other)
+{
+  const auto& o = dynamic_cast<const IndexedImageMember&>(other);
+  indices = o.indices;
+  palette = o.palette;
+}
+
+//##################################################################################################
+tp_image_utils::ColorMap IndexedImageMember::colorMap() const
+{
+  TPPixel lookup[256];
+  for(size_t i=0; i<256; i++)
+    lookup[i] = (i<palette.size())?palette.at(i):TPPixel(0, 0, 0);
+
+  tp_image_utils::ColorMap colorMap;
+  colorMap.setSize(indices.width(), indices.height());
+
+  const uint8_t* s = indices.constData();
+  const uint8_t* sMax = s + indices.size();
+  TPPixel* dst = colorMap.data();
+
+  for(; s<sMax; s++, dst++)
+    (*dst) = lookup[*s];
+
+  return colorMap;
+}
+
+}
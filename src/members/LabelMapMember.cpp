@@ -0,0 +1,19 @@
+#include "tp_pipeline_image_utils/members/LabelMapMember.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+LabelMapMember::LabelMapMember(const std::string& name):
+  tp_data::AbstractMember(name)
+{
+
+}
+
+//##################################################################################################
+void LabelMapMember::copyData(const tp_data::AbstractMember& other)
+{
+  data = dynamic_cast<const LabelMapMember&>(other).data;
+}
+
+}
@@ -0,0 +1,126 @@
+#include "tp_pipeline_image_utils/members/PaddedImageMember.h"
+
+namespace tp_pipeline_image_utils
+{
+
+//##################################################################################################
+struct PaddedImageMember::Private
+{
+  std::shared_ptr<const tp_image_utils::ColorMap> colorSource;
+  std::shared_ptr<const tp_image_utils::ByteMap> byteSource;
+  size_t border{0};
+  BorderMode mode{BorderMode::Constant};
+  TPPixel color{0, 0, 0};
+  uint8_t value{0};
+};
+
+//##################################################################################################
+PaddedImageMember::PaddedImageMember(const std::string& name):
+  tp_data::AbstractMember(name),
+  d(new Private())
+{
+
+}
+
+//##################################################################################################
+PaddedImageMember::~PaddedImageMember()
+{
+  delete d;
+}
+
+//##################################################################################################
+void PaddedImageMember::copyData(const tp_data::AbstractMember& other)
+{
+  const auto& o = dynamic_cast<const PaddedImageMember&>(other);
+  *d = *o.d;
+}
+
+//##################################################################################################
+void PaddedImageMember::setSource(const std::shared_ptr<const tp_image_utils::ColorMap>& source, size_t border, BorderMode mode, TPPixel color)
+{
+  d->colorSource = source;
+  d->byteSource = nullptr;
+  d->border = border;
+  d->mode = mode;
+  d->color = color;
+}
+
+//##################################################################################################
+void PaddedImageMember::setSource(const std::shared_ptr<const tp_image_utils::ByteMap>& source, size_t border, BorderMode mode, uint8_t value)
+{
+  d->colorSource = nullptr;
+  d->byteSource = source;
+  d->border = border;
+  d->mode = mode;
+  d->value = value;
+}
+
+//##################################################################################################
+const tp_image_utils::ColorMap* PaddedImageMember::colorSource() const
+{
+  return d->colorSource.get();
+}
+
+//##################################################################################################
+const tp_image_utils::ByteMap* PaddedImageMember::byteSource() const
+{
+  return d->byteSource.get();
+}
+
+//##################################################################################################
+size_t PaddedImageMember::border() const
+{
+  return d->border;
+}
+
+//##################################################################################################
+BorderMode PaddedImageMember::mode() const
+{
+  return d->mode;
+}
+
+//##################################################################################################
+TPPixel PaddedImageMember::color() const
+{
+  return d->color;
+}
+
+//##################################################################################################
+uint8_t PaddedImageMember::value() const
+{
+  return d->value;
+}
+
+//##################################################################################################
+size_t PaddedImageMember::width() const
+{
+  size_t w = d->colorSource?d->colorSource->width():(d->byteSource?d->byteSource->width():0);
+  return w + d->border*2;
+}
+
+//##################################################################################################
+size_t PaddedImageMember::height() const
+{
+  size_t h = d->colorSource?d->colorSource->height():(d->byteSource?d->byteSource->height():0);
+  return h + d->border*2;
+}
+
+//##################################################################################################
+tp_image_utils::ColorMap PaddedImageMember::colorMap() const
+{
+  if(!d->colorSource)
+    return tp_image_utils::ColorMap();
+
+  return padColorMap(*d->colorSource, d->border, d->mode, d->color);
+}
+
+//##################################################################################################
+tp_image_utils::ByteMap PaddedImageMember::byteMap() const
+{
+  if(!d->byteSource)
+    return tp_image_utils::ByteMap();
+
+  return padByteMap(*d->byteSource, d->border, d->mode, d->value);
+}
+
+}
@@ -1,4 +1,6 @@
 #include "tp_pipeline_image_utils/step_delegates/AddBorderStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/members/PaddedImageMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 
@@ -33,6 +35,9 @@ void AddBorderStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
   size_t width = stepDetails->parameterValue<size_t>("Width");
   width = tpBound(size_t(0), width, size_t(1000));
 
+  bool virtualBorder = (stepDetails->parameterValue<std::string>(outputFormatSID()) == "Virtual");
+  BorderMode mode = borderModeFromString(stepDetails->parameterValue<std::string>(borderModeSID()));
+
   if(input.previousSteps.empty())
   {
     output.addError("No input data found.");
@@ -41,19 +46,45 @@ void AddBorderStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   for(const auto& member : input.previousSteps.back()->members())
   {
+    // The upstream member may be freed before this output, so the unpadded source is copied once
+    // and shared by copies of the padded member. Only plain images are padded virtually.
+    if(virtualBorder)
+    {
+      if(auto byteMapMember = dynamic_cast<tp_data_image_utils::ByteMapMember*>(member); byteMapMember)
+      {
+        auto paddedMember = new PaddedImageMember(stepDetails->lookupOutputName("Output data"));
+        output.addMember(paddedMember);
+        paddedMember->setSource(std::make_shared<const tp_image_utils::ByteMap>(byteMapMember->data), width, mode, value);
+        continue;
+      }
+
+      if(auto colorMapMember = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member); colorMapMember)
+      {
+        auto paddedMember = new PaddedImageMember(stepDetails->lookupOutputName("Output data"));
+        output.addMember(paddedMember);
+        paddedMember->setSource(std::make_shared<const tp_image_utils::ColorMap>(colorMapMember->data), width, mode, color);
+        continue;
+      }
+    }
 
-    if(auto byteMapMember = dynamic_cast<tp_data_image_utils::ByteMapMember*>(member); byteMapMember)
+    if(auto byteMap = byteMapFromMember(member); byteMap)
     {
       auto newByteMapMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(newByteMapMember);
-      newByteMapMember->data = tp_image_utils_functions::addBorder(byteMapMember->data, width, value);
+      if(mode == BorderMode::Constant)
+        newByteMapMember->data = tp_image_utils_functions::addBorder(*byteMap, width, value);
+      else
+        newByteMapMember->data = padByteMap(*byteMap, width, mode, value);
     }
 
-    else if(auto colorMapMember = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member); colorMapMember)
+    else if(auto colorMap = colorMapFromMember(member); colorMap)
     {
       auto newColorMapMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(newColorMapMember);
-      newColorMapMember->data = tp_image_utils_functions::addBorder(colorMapMember->data, width, color);
+      if(mode == BorderMode::Constant)
+        newColorMapMember->data = tp_image_utils_functions::addBorder(*colorMap, width, color);
+      else
+        newColorMapMember->data = padColorMap(*colorMap, width, mode, color);
     }
   }
 }
@@ -106,6 +137,28 @@ void AddBorderStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDetail
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = outputFormatSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Virtual keeps the unpadded input and computes the border when it is read.";
+    param.setEnum({"Copy", "Virtual"});
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
+  {
+    tp_utils::StringID name = borderModeSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "How the border is filled, Constant uses the fill value or color.";
+    param.setEnum(borderModes());
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
@@ -1,4 +1,6 @@
 #include "tp_pipeline_image_utils/step_delegates/BitwiseStepDelegate.h"
+#include "tp_pipeline_image_utils/functions/Bitwise.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
 #include "tp_image_utils_functions/Bitwise.h"
@@ -10,6 +12,31 @@
 
 namespace tp_pipeline_image_utils
 {
+namespace
+{
+//##################################################################################################
+std::vector<std::string> splitNames(const std::string& text)
+{
+  std::vector<std::string> names;
+  size_t pos=0;
+  while(pos<=text.size())
+  {
+    size_t end = text.find_first_of(",\n", pos);
+    if(end==std::string::npos)
+      end = text.size();
+
+    std::string name = text.substr(pos, end-pos);
+    size_t b = name.find_first_not_of(" \t\r");
+    size_t e = name.find_last_not_of(" \t\r");
+    if(b!=std::string::npos)
+      names.push_back(name.substr(b, e-b+1));
+
+    pos = end+1;
+  }
+  return names;
+}
+}
+
 //##################################################################################################
 BitwiseStepDelegate::BitwiseStepDelegate():
   AbstractStepDelegate(bitwiseSID(), {processingSID()})
@@ -22,16 +49,14 @@ void BitwiseStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
                                       const tp_pipeline::StepInput& input,
                                       tp_data::Collection& output) const
 {
-  auto operation = tp_image_utils_functions::logicOpFromString(stepDetails->parameterValue<std::string>("Logical operation"));
+  std::string operationName = stepDetails->parameterValue<std::string>("Logical operation");
+  auto operation = tp_image_utils_functions::logicOpFromString(operationName);
 
   std::string pName = stepDetails->parameterValue<std::string>("P");
   std::string qName = stepDetails->parameterValue<std::string>("Q");
 
-  tp_data_image_utils::ByteMapMember* p{nullptr};
-  tp_data_image_utils::ByteMapMember* q{nullptr};
-
-  input.memberCast(pName, p);
-  input.memberCast(qName, q);
+  auto p = findByteMap(input, pName);
+  auto q = findByteMap(input, qName);
 
   if(!p)
     p=q;
@@ -39,11 +64,43 @@ void BitwiseStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
   if(!q)
     q=p;
 
-  if(p&&q)
+  std::vector<std::shared_ptr<const tp_image_utils::ByteMap>> extra;
+  for(const auto& name : splitNames(stepDetails->parameterValue<std::string>("Extra inputs")))
+  {
+    if(auto member = findByteMap(input, name); member)
+      extra.push_back(member);
+    else
+      output.addError("Failed to find extra input: " + name);
+  }
+
+  TruthTable table{0};
+  if(p&&q && truthTable(operation, table))
   {
+    std::vector<const tp_image_utils::ByteMap*> operands{q.get()};
+    for(const auto& member : extra)
+      operands.push_back(member.get());
+
+    for(const auto operand : operands)
+    {
+      if(operand->width()!=p->width() || operand->height()!=p->height())
+      {
+        output.addError("Inputs are different sizes.");
+        return;
+      }
+    }
+
     auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
-    outMember->data = tp_image_utils_functions::bitwise(p->data, q->data, operation);
+    outMember->data = *p;
+    bitwiseInPlace(outMember->data, operands, table);
+  }
+  else if(p&&q)
+  {
+    auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
+    output.addMember(outMember);
+    outMember->data = tp_image_utils_functions::bitwise(*p, *q, operation);
+    for(const auto& member : extra)
+      outMember->data = tp_image_utils_functions::bitwise(outMember->data, *member, operation);
   }
   else
   {
@@ -92,6 +149,18 @@ void BitwiseStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDetails)
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = "Extra inputs";
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Names of more images separated by commas, each is combined with the result in turn.";
+    param.type = tp_pipeline::stringSID();
+    param.value = tpGetVariantValue<std::string>(param.value, "");
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
@@ -1,4 +1,6 @@
 #include "tp_pipeline_image_utils/step_delegates/CellSegmentStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/members/LabelMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
 #include "tp_image_utils_functions/CellSegment.h"
@@ -19,6 +21,9 @@ enum class InitialCoordMode_lt
   Simple,
   SignedDistanceField
 };
+
+//! The cell limit when labels are written to a LabelMapMember.
+const int maxWideLabels = 1000000;
 }
 
 //##################################################################################################
@@ -47,27 +52,76 @@ void CellSegmentStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
         stepDetails->parameterValue<std::string>(growModeSID()));
 
   std::string initialCoordMode = stepDetails->parameterValue<std::string>(initialCoordModeSID());
+  bool frontier = (initialCoordMode != "Simple" &&
+                   stepDetails->parameterValue<std::string>(engineSID()) == "Frontier");
+  bool wideLabels = (initialCoordMode != "Simple" &&
+                     stepDetails->parameterValue<std::string>(outputFormatSID()) == "Wide labels");
 
   params.distanceFieldRadius = tpBound(10, params.distanceFieldRadius, 2048);
   params.minRadius           = tpBound( 2, params.minRadius,            512);
-  params.maxInitialCells     = tpBound( 1, params.maxInitialCells,      255);
+  params.maxInitialCells     = tpBound( 1, params.maxInitialCells,      (frontier && wideLabels)?maxWideLabels:255);
   params.growCellsPasses     = tpBound( 0, params.growCellsPasses,     10000);
 
   const tp_data_image_utils::ByteMapMember* labels{nullptr};
   input.memberCast(labelsName, labels);
 
-  const tp_data_image_utils::ByteMapMember* src{nullptr};
-  input.memberCast(monoName, src);
-  if(src)
+  const LabelMapMember* wideLabelsInput{nullptr};
+  input.memberCast(labelsName, wideLabelsInput);
+
+  auto src = findByteMap(input, monoName);
+  if(!src)
+    return;
+
+  LabelMap result;
+  tp_image_utils::ByteMap byteResult;
+
+  if(frontier)
+  {
+    FrontierCellSegmentParameters frontierParams;
+    frontierParams.distanceFieldRadius = size_t(params.distanceFieldRadius);
+    frontierParams.minRadius           = size_t(params.minRadius);
+    frontierParams.maxInitialCells     = size_t(params.maxInitialCells);
+    frontierParams.growCellsPasses     = size_t(params.growCellsPasses);
+    frontierParams.growth = (stepDetails->parameterValue<std::string>(growModeSID()) == "Flood")?CellGrowth::Flood:CellGrowth::Box;
+
+    LabelMap seedLabels;
+    const LabelMap* seeds{nullptr};
+    if(wideLabelsInput)
+      seeds = &wideLabelsInput->data;
+    else if(labels)
+    {
+      seedLabels = toLabelMap(labels->data);
+      seeds = &seedLabels;
+    }
+
+    result = frontierCellSegment(*src, seeds, frontierParams);
+    if(!wideLabels)
+      byteResult = toByteMap(result);
+  }
+  else
   {
-    auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
-    output.addMember(outMember);
     if(initialCoordMode == "Simple")
-      outMember->data = tp_image_utils_functions::cellSegmentSimple(src->data, params);
+      byteResult = tp_image_utils_functions::cellSegmentSimple(*src, params);
     else if(labels)
-      outMember->data = tp_image_utils_functions::cellSegment(src->data, labels->data, params);
+      byteResult = tp_image_utils_functions::cellSegment(*src, labels->data, params);
     else
-      outMember->data = tp_image_utils_functions::cellSegment(src->data, params);
+      byteResult = tp_image_utils_functions::cellSegment(*src, params);
+
+    if(wideLabels)
+      result = toLabelMap(byteResult);
+  }
+
+  if(wideLabels)
+  {
+    auto outMember = new LabelMapMember(stepDetails->lookupOutputName("Output data"));
+    output.addMember(outMember);
+    outMember->data = std::move(result);
+  }
+  else
+  {
+    auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
+    output.addMember(outMember);
+    outMember->data = std::move(byteResult);
   }
 }
 
@@ -107,6 +161,12 @@ void CellSegmentStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDeta
     validParams.push_back(name);
   }
 
+  bool frontier = (initialCoordMode == InitialCoordMode_lt::SignedDistanceField &&
+                   stepDetails->parameterValue<std::string>(engineSID()) == "Frontier");
+
+  bool wideLabels = (initialCoordMode == InitialCoordMode_lt::SignedDistanceField &&
+                     stepDetails->parameterValue<std::string>(outputFormatSID()) == "Wide labels");
+
   {
     const tp_utils::StringID& name = maximumInitialCellsSID();
     auto param = tpGetMapValue(parameters, name);
@@ -114,7 +174,7 @@ void CellSegmentStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDeta
     param.description = "The maximum number of initial cells to generate.";
     param.type = tp_pipeline::intSID();
     param.min = 1;
-    param.max = 255;
+    param.max = (frontier && wideLabels)?maxWideLabels:255;
 
     if(param.value.index() == 0)
       param.value = 40;
@@ -211,6 +271,32 @@ void CellSegmentStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDeta
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = engineSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Frontier grows cells from their boundaries on all threads, its cells differ from Default.";
+    param.setEnum({"Default", "Frontier"});
+
+    param.enabled = (initialCoordMode == InitialCoordMode_lt::SignedDistanceField);
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
+  {
+    tp_utils::StringID name = outputFormatSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Wide labels outputs 32 bit labels, byte output clamps labels to 255.";
+    param.setEnum({"Byte", "Wide labels"});
+
+    param.enabled = (initialCoordMode == InitialCoordMode_lt::SignedDistanceField);
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   {
     const tp_utils::StringID& name = labelsImageSID();
     auto param = tpGetMapValue(parameters, name);
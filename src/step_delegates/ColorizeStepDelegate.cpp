@@ -1,4 +1,7 @@
 #include "tp_pipeline_image_utils/step_delegates/ColorizeStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/members/IndexedImageMember.h"
+#include "tp_pipeline_image_utils/members/LabelMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 
@@ -23,21 +26,50 @@ void ColorizeStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
                                        tp_data::Collection& output) const
 {
   std::string grayName  = stepDetails->parameterValue<std::string>(grayImageSID());
+  bool indexed = (stepDetails->parameterValue<std::string>(outputFormatSID()) == "Indexed");
 
-  const tp_data_image_utils::ByteMapMember* src{nullptr};
-  input.memberCast(grayName, src);
+  // Wide labels can't be indexed by a byte so they are always written as color.
+  const LabelMapMember* labels{nullptr};
+  input.memberCast(grayName, labels);
+  if(labels)
+  {
+    auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
+    output.addMember(outMember);
+    outMember->data.setSize(labels->data.width, labels->data.height);
+
+    const uint32_t* s = labels->data.labels.data();
+    const uint32_t* sMax = s + labels->data.labels.size();
+    TPPixel* dst = outMember->data.data();
+
+    for(; s<sMax; s++, dst++)
+      (*dst) = makeLabelColor(*s);
+    return;
+  }
+
+  auto src = findByteMap(input, grayName);
   if(!src)
     return;
 
-  size_t w = src->data.width();
-  size_t h = src->data.height();
+  if(indexed)
+  {
+    auto outMember = new IndexedImageMember(stepDetails->lookupOutputName("Output data"));
+    output.addMember(outMember);
+    outMember->indices = *src;
+    outMember->palette.reserve(256);
+    for(size_t i=0; i<256; i++)
+      outMember->palette.push_back(makeColor(i));
+    return;
+  }
+
+  size_t w = src->width();
+  size_t h = src->height();
 
   auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
   output.addMember(outMember);
   outMember->data.setSize(w, h);
 
-  const uint8_t* s = src->data.constData();
-  const uint8_t* sMax = s + src->data.size();
+  const uint8_t* s = src->constData();
+  const uint8_t* sMax = s + src->size();
   TPPixel* dst = outMember->data.data();
 
   for(; s<sMax; s++, dst++)
@@ -56,13 +88,23 @@ void ColorizeStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDetails
     const tp_utils::StringID& name = grayImageSID();
     auto param = tpGetMapValue(parameters, name);
     param.name = name;
-    param.description = "The source gray image.";
+    param.description = "The source gray image or wide label map.";
     param.type = tp_pipeline::namedDataSID();
 
     stepDetails->setParamerter(param);
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = outputFormatSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Output a color image or the gray image with a palette attached.";
+    param.setEnum({"Color", "Indexed"});
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/ConvolutionMatrixStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 
 #include "tp_image_utils_functions/ConvolutionMatrix.h"
@@ -33,13 +34,13 @@ void ConvolutionMatrixStepDelegate::executeStep(tp_pipeline::StepDetails* stepDe
 
   for(const auto& member : input.previousSteps.back()->members())
   {
-    auto byteMapMember = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member);
-    if(!byteMapMember)
+    auto colorMap = colorMapFromMember(member);
+    if(!colorMap)
       continue;
 
     auto newByteMapMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(newByteMapMember);
-    newByteMapMember->data = matrix.convolve(byteMapMember->data);
+    newByteMapMember->data = matrix.convolve(*colorMap);
   }
 }
 
@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/DeNoiseStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
 #include "tp_image_utils_functions/DeNoise.h"
@@ -146,11 +147,8 @@ void DeNoiseStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   if(!grayName.empty())
   {
-    const tp_data_image_utils::ByteMapMember* src{nullptr};
-    input.memberCast(grayName, src);
-
-    if(src)
-      processGray(src->data);
+    if(auto src = findByteMap(input, grayName); src)
+      processGray(*src);
     else
       output.addError("Failed to find source gray image.");
   }
@@ -164,9 +162,8 @@ void DeNoiseStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
     for(const auto member : input.previousSteps.back()->members())
     {
-      auto src = dynamic_cast<const tp_data_image_utils::ByteMapMember*>(member);
-      if(src)
-        processGray(src->data);
+      if(auto src = byteMapFromMember(member); src)
+        processGray(*src);
     }
   }
 }
@@ -1,4 +1,6 @@
 #include "tp_pipeline_image_utils/step_delegates/DrawMaskStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/functions/DrawMask.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 
@@ -30,17 +32,24 @@ void DrawMaskStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
   TPPixel color(stepDetails->parameterValue<std::string>(colorSID()));
   uint8_t value = uint8_t(stepDetails->parameterValue<int>(valueSID()));
 
-  const tp_data_image_utils::ColorMapMember* image{nullptr};
-  const tp_data_image_utils::ByteMapMember*   mask{nullptr};
+  auto mask = findByteMap(input, maskName);
+  if(!mask)
+    return;
 
-  input.memberCast(imageName, image);
-  input.memberCast( maskName,  mask);
-  if(image && mask)
+  if(auto image = findColorMap(input, imageName); image)
   {
     auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
-    outMember->data = image->data;
-    tp_image_utils_functions::drawMask(outMember->data, color, mask->data, value);
+    outMember->data = *image;
+
+    if(stepDetails->parameterValue<std::string>(engineSID()) == "SWAR")
+    {
+      auto opacity = uint8_t(stepDetails->parameterValue<int>("Opacity"));
+      if(!drawMaskBlend(outMember->data, color, *mask, value, opacity))
+        output.addError("The mask and image must be the same size.");
+    }
+    else
+      tp_image_utils_functions::drawMask(outMember->data, color, *mask, value);
   }
 }
 
@@ -101,6 +110,32 @@ void DrawMaskStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDetails
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = engineSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "SWAR compares 8 mask bytes at a time and can blend the color into the image.";
+    param.setEnum({"Default", "SWAR"});
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
+  {
+    tp_utils::StringID name = "Opacity";
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "How strongly the color is blended into the image, 255 replaces the pixels.";
+    param.type = tp_pipeline::intSID();
+    param.min = 0;
+    param.max = 255;
+    param.validateBounds(255);
+    param.enabled = (stepDetails->parameterValue<std::string>(engineSID()) == "SWAR");
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
@@ -1,4 +1,6 @@
 #include "tp_pipeline_image_utils/step_delegates/DrawShapesStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/functions/Rasterise.h"
 #include "tp_data_image_utils/members/GridMember.h"
 #include "tp_data_image_utils/members/LineCollectionMember.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
@@ -36,15 +38,31 @@ void DrawShapesStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
   std::string linesName = stepDetails->parameterValue<std::string>(     linesSID());
   std::string  gridName = stepDetails->parameterValue<std::string>(      gridSID());
 
-  const tp_data_image_utils::ColorMapMember* image{nullptr};
-  input.memberCast(imageName, image);
-
+  auto image = findColorMap(input, imageName);
   if(!image)
     return;
 
   auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
   output.addMember(outMember);
-  outMember->data = image->data;
+  outMember->data = *image;
+
+  if(stepDetails->parameterValue<std::string>(engineSID()) == "Batched")
+  {
+    LineBatch batch;
+
+    const tp_data_image_utils::LineCollectionMember* lines{nullptr};
+    input.memberCast(linesName, lines);
+    if(lines)
+      batch.addLines(lines->data, color);
+
+    const tp_data_image_utils::GridMember* grid{nullptr};
+    input.memberCast(gridName, grid);
+    if(grid)
+      batch.addGrid(grid->data, outMember->data.width(), outMember->data.height(), color);
+
+    batch.draw(outMember->data);
+    return;
+  }
 
   {
     const tp_data_image_utils::LineCollectionMember* lines{nullptr};
@@ -123,6 +141,17 @@ void DrawShapesStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDetai
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = engineSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Batched draws everything into one image in parallel bands.";
+    param.setEnum({"Default", "Batched"});
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
@@ -1,4 +1,7 @@
 #include "tp_pipeline_image_utils/step_delegates/EdgeDetectStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/functions/Gradient.h"
+#include "tp_pipeline_image_utils/members/PaddedImageMember.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
@@ -29,6 +32,37 @@ Mode_lt modeFromString(const std::string& mode)
 
   return Mode_lt::Edge;
 }
+
+//##################################################################################################
+//! Point a gradient source at a member, padded images are read without expanding them.
+/*!
+Indexed images are expanded into color, which is then held by color until the source is done with.
+*/
+bool gradientSourceFromMember(const tp_data::AbstractMember* member,
+                              GradientSource& src,
+                              std::shared_ptr<const tp_image_utils::ColorMap>& color)
+{
+  if(auto padded = dynamic_cast<const PaddedImageMember*>(member); padded)
+  {
+    src.color     = padded->colorSource();
+    src.byte      = padded->byteSource();
+    src.border    = padded->border();
+    src.mode      = padded->mode();
+    src.fillColor = padded->color();
+    src.fillValue = padded->value();
+    return src.color || src.byte;
+  }
+
+  if(auto gray = dynamic_cast<const tp_data_image_utils::ByteMapMember*>(member); gray)
+  {
+    src.byte = &gray->data;
+    return true;
+  }
+
+  color = colorMapFromMember(member);
+  src.color = color.get();
+  return src.color;
+}
 }
 
 //##################################################################################################
@@ -51,15 +85,73 @@ void EdgeDetectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   Mode_lt mode = modeFromString(stepDetails->parameterValue<std::string>(modeSID()));
 
-  auto processColor = [&](const tp_data_image_utils::ColorMapMember* src)
+  if(stepDetails->parameterValue<std::string>(engineSID()) == "Sobel")
+  {
+    auto colorThresholdWide = size_t(stepDetails->parameterValue<int>(colorThresholdSID()));
+    auto feature = (mode == Mode_lt::Corner)?GradientFeature::Corner:GradientFeature::Edge;
+    bool gradientOutputs = (stepDetails->parameterValue<std::string>("Gradient outputs") == "Yes");
+
+    auto process = [&](const tp_data::AbstractMember* member)
+    {
+      GradientSource src;
+      std::shared_ptr<const tp_image_utils::ColorMap> color;
+      if(!gradientSourceFromMember(member, src, color))
+        return false;
+
+      // Like the Default engine corners are found on the brightness of color images.
+      src.gray = (feature == GradientFeature::Corner);
+
+      auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
+      output.addMember(outMember);
+
+      FloatMap* magnitude{nullptr};
+      FloatMap* orientation{nullptr};
+      if(gradientOutputs)
+      {
+        auto magnitudeMember = new FloatMapMember(stepDetails->lookupOutputName("Magnitude"));
+        output.addMember(magnitudeMember);
+        magnitude = &magnitudeMember->data;
+
+        auto orientationMember = new FloatMapMember(stepDetails->lookupOutputName("Orientation"));
+        output.addMember(orientationMember);
+        orientation = &orientationMember->data;
+      }
+
+      auto threshold = src.color?colorThresholdWide:size_t(grayThreshold);
+      outMember->data = sobelDetect(src, feature, threshold, magnitude, orientation);
+      return true;
+    };
+
+    if(!colorName.empty() && !process(input.member(colorName)))
+      output.addError("Failed to find source color image.");
+
+    if(!grayName.empty() && !process(input.member(grayName)))
+      output.addError("Failed to find source gray image.");
+
+    if(colorName.empty() && grayName.empty())
+    {
+      if(input.previousSteps.empty())
+      {
+        output.addError("No input data found.");
+        return;
+      }
+
+      for(const auto& member : input.previousSteps.back()->members())
+        process(member);
+    }
+
+    return;
+  }
+
+  auto processColor = [&](const tp_image_utils::ColorMap& src)
   {
     auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
 
     if(mode == Mode_lt::Edge)
-      outMember->data = tp_image_utils_functions::edgeDetect(src->data, colorThreshold);
+      outMember->data = tp_image_utils_functions::edgeDetect(src, colorThreshold);
     else if(mode == Mode_lt::Corner)
-      outMember->data = tp_image_utils_functions::edgeDetectCorner(tp_image_utils::ByteMap(src->data), colorThreshold);
+      outMember->data = tp_image_utils_functions::edgeDetectCorner(tp_image_utils::ByteMap(src), colorThreshold);
   };
 
   auto processGray = [&](const tp_data_image_utils::ByteMapMember* src)
@@ -75,11 +167,8 @@ void EdgeDetectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   if(!colorName.empty())
   {
-    const tp_data_image_utils::ColorMapMember* src{nullptr};
-    input.memberCast(colorName, src);
-
-    if(src)
-      processColor(src);
+    if(auto src = findColorMap(input, colorName); src)
+      processColor(*src);
     else
       output.addError("Failed to find source color image.");
   }
@@ -105,8 +194,8 @@ void EdgeDetectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
     for(const auto& member : input.previousSteps.back()->members())
     {
-      if(auto color = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member); color)
-        processColor(color);
+      if(auto color = colorMapFromMember(member); color)
+        processColor(*color);
 
       else if(auto gray = dynamic_cast<tp_data_image_utils::ByteMapMember*>(member); gray)
         processGray(gray);
@@ -117,8 +206,6 @@ void EdgeDetectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 //##################################################################################################
 void EdgeDetectStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDetails) const
 {
-  stepDetails->setOutputNames({"Output data"});
-
   std::vector<tp_utils::StringID> validParams;
   const auto& parameters = stepDetails->parameters();
 
@@ -134,11 +221,41 @@ void EdgeDetectStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDetai
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = engineSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Sobel reads color, gray and virtually padded images directly in parallel row bands.";
+    param.setEnum({"Default", "Sobel"});
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
+  bool sobel = (stepDetails->parameterValue<std::string>(engineSID()) == "Sobel");
+
+  {
+    tp_utils::StringID name = "Gradient outputs";
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Also output the gradient magnitude and orientation in radians as float maps.";
+    param.setEnum({"No", "Yes"});
+    param.enabled = sobel;
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
+  if(sobel && stepDetails->parameterValue<std::string>("Gradient outputs") == "Yes")
+    stepDetails->setOutputNames({"Output data", "Magnitude", "Orientation"});
+  else
+    stepDetails->setOutputNames({"Output data"});
+
   {
     tp_utils::StringID name = "Color threshold";
     auto param = tpGetMapValue(parameters, name);
     param.name = name;
-    param.description = "The threshold to use for color images.";
+    param.description = "The threshold to use for color images, Sobel compares it with the gradient length divided by 4.";
     param.type = tp_pipeline::intSID();
     param.min = 0;
     param.max = 440;
@@ -152,7 +269,7 @@ void EdgeDetectStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDetai
     tp_utils::StringID name = "Gray threshold";
     auto param = tpGetMapValue(parameters, name);
     param.name = name;
-    param.description = "The threshold to use for gray images.";
+    param.description = "The threshold to use for gray images, Sobel compares it with the gradient length divided by 4.";
     param.type = tp_pipeline::intSID();
     param.min = 0;
     param.max = 255;
@@ -1,8 +1,12 @@
 #include "tp_pipeline_image_utils/step_delegates/ExtractPolygonsStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/functions/Contours.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
 #include "tp_data_math_utils/members/PolygonsMember.h"
 
+#include "tp_math_utils/Polygon.h"
+
 #include "tp_image_utils_functions/ExtractPolygons.h"
 
 #include "tp_pipeline/StepDetails.h"
@@ -17,6 +21,36 @@
 namespace tp_pipeline_image_utils
 {
 
+namespace
+{
+//##################################################################################################
+std::vector<glm::vec2> toPoints(const std::vector<std::array<float, 2>>& contour)
+{
+  std::vector<glm::vec2> points;
+  points.reserve(contour.size());
+  for(const auto& v : contour)
+    points.emplace_back(v[0], v[1]);
+  return points;
+}
+
+//##################################################################################################
+//! Append the traced polygons of one label, or of every label if label is 0.
+void appendPolygons(const std::vector<LabelPolygon>& src, uint8_t label, std::vector<tp_math_utils::Polygon>& dst)
+{
+  for(const auto& labelPolygon : src)
+  {
+    if(label && labelPolygon.label!=label)
+      continue;
+
+    tp_math_utils::Polygon& polygon = dst.emplace_back();
+    polygon.outline = toPoints(labelPolygon.outline);
+    polygon.holes.reserve(labelPolygon.holes.size());
+    for(const auto& hole : labelPolygon.holes)
+      polygon.holes.push_back(toPoints(hole));
+  }
+}
+}
+
 //##################################################################################################
 ExtractPolygonsStepDelegate::ExtractPolygonsStepDelegate():
   AbstractStepDelegate(extractPolygonsSID(), {findAndSegmentSID()})
@@ -31,13 +65,19 @@ void ExtractPolygonsStepDelegate::executeStep(tp_pipeline::StepDetails* stepDeta
 {
   std::string grayName = stepDetails->parameterValue<std::string>(grayImageSID());
 
-  const tp_data_image_utils::ByteMapMember* src{nullptr};
-  input.memberCast(grayName, src);
+  auto src = findByteMap(input, grayName);
   if(src)
   {
     auto outMember = new tp_data_math_utils::PolygonsMember(stepDetails->lookupOutputName("Output polygon"));
     output.addMember(outMember);
-    tp_image_utils_functions::ExtractPolygon::simplePolygonExtraction(src->data, outMember->data);
+    if(stepDetails->parameterValue<std::string>(engineSID()) == "Marching squares")
+    {
+      float tolerance = stepDetails->parameterValue<float>("Simplify tolerance");
+      auto label = uint8_t(stepDetails->parameterValue<int>("Label"));
+      appendPolygons(traceLabelPolygons(*src, tolerance), label, outMember->data);
+    }
+    else
+      tp_image_utils_functions::ExtractPolygon::simplePolygonExtraction(*src, outMember->data);
   }
 }
 
@@ -60,6 +100,47 @@ void ExtractPolygonsStepDelegate::fixupParameters(tp_pipeline::StepDetails* step
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = engineSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Marching squares traces every non zero region of a label map with its holes.";
+    param.setEnum({"Default", "Marching squares"});
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
+  {
+    tp_utils::StringID name = "Simplify tolerance";
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Remove vertices that are closer than this many pixels to the simplified outline, 0 keeps every corner.";
+    param.type = "Float";
+    param.min = 0.0f;
+    param.max = 100.0f;
+    param.validateBounds<float>(0.0f);
+    param.enabled = (stepDetails->parameterValue<std::string>(engineSID()) == "Marching squares");
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
+  {
+    tp_utils::StringID name = "Label";
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Only output the regions with this value, 0 outputs the regions of every non zero value.";
+    param.type = tp_pipeline::intSID();
+    param.min = 0;
+    param.max = 255;
+    param.validateBounds<int>(0);
+    param.enabled = (stepDetails->parameterValue<std::string>(engineSID()) == "Marching squares");
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
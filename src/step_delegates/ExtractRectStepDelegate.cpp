@@ -1,4 +1,6 @@
 #include "tp_pipeline_image_utils/step_delegates/ExtractRectStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/functions/ExtractGrid.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 #include "tp_data_image_utils/members/LineCollectionMember.h"
@@ -161,6 +163,18 @@ void _fixupParameters(tp_pipeline::StepDetails* stepDetails)
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = engineSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Parallel warps bands of cell rows on separate threads.";
+    param.setEnum({"Default",
+                   "Parallel"});
+    param.enabled = areaMode==AreaMode_lt::Grid;
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
@@ -186,15 +200,16 @@ void ExtractRectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   AreaMode_lt areaMode = areaModeFromString(stepDetails->parameterValue<std::string>(modeSID()));  
   auto originMode = originModeFromString(stepDetails->parameterValue<std::string>(originModeSID()));
+  bool parallelGrid = (stepDetails->parameterValue<std::string>(engineSID()) == "Parallel");
 
   std::string clippingAreaName = stepDetails->parameterValue<std::string>(clippingAreaSID());
   std::string clippingGridName = stepDetails->parameterValue<std::string>(clippingGridSID());
 
   //-- This is the image to cut the shape from -----------------------------------------------------
-  const tp_data_image_utils::ColorMapMember* src{nullptr};
+  std::shared_ptr<const tp_image_utils::ColorMap> src;
   {
     std::string sourceImageName = stepDetails->parameterValue<std::string>(colorImageSID());
-    input.memberCast(sourceImageName, src);
+    src = findColorMap(input, sourceImageName);
 
     if(!src)
     {
@@ -227,14 +242,14 @@ void ExtractRectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   std::vector<std::string> errors;
 
-  if(src->data.size()>0)
+  if(src->size()>0)
   {
     if(width<1)
     {
       if(clippingGrid && clippingGrid->data.xCells>0)
         width = size_t(float(clippingGrid->data.xCells) * ceil(clippingGrid->data.xAxis.length()));
       else
-        width = size_t(src->data.width());
+        width = size_t(src->width());
     }
 
     if(height<1)
@@ -242,7 +257,7 @@ void ExtractRectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
       if(clippingGrid && clippingGrid->data.yCells>0)
         height = size_t(float(clippingGrid->data.yCells) * ceil(clippingGrid->data.yAxis.length()));
       else
-        height = size_t(src->data.height());
+        height = size_t(src->height());
     }
 
     if(areaMode == AreaMode_lt::Area)
@@ -251,7 +266,7 @@ void ExtractRectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
       {
         auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
         output.addMember(outMember);
-        outMember->data = tp_image_utils_functions::ExtractRect::extractRect(src->data,
+        outMember->data = tp_image_utils_functions::ExtractRect::extractRect(*src,
                                                                              clippingArea->data.at(0),
                                                                              width,
                                                                              height,
@@ -265,10 +280,13 @@ void ExtractRectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
       {
         auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
         output.addMember(outMember);
-        outMember->data = tp_image_utils_functions::ExtractRect::extractRect(src->data,
-                                                                             clippingGrid->data,
-                                                                             width,
-                                                                             height, errors);
+        if(parallelGrid)
+          outMember->data = extractGrid(*src, clippingGrid->data, width, height, errors);
+        else
+          outMember->data = tp_image_utils_functions::ExtractRect::extractRect(*src,
+                                                                               clippingGrid->data,
+                                                                               width,
+                                                                               height, errors);
       }
     }
 
@@ -278,15 +296,15 @@ void ExtractRectStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
       {
         if(originMode==OriginMode::CenterCrop)
         {
-          if(src->data.width()>width)
-            x = (src->data.width()-width) / 2;
-          if(src->data.height()>height)
-            y = (src->data.height()-height) / 2;
+          if(src->width()>width)
+            x = (src->width()-width) / 2;
+          if(src->height()>height)
+            y = (src->height()-height) / 2;
         }
 
         auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
         output.addMember(outMember);
-        outMember->data = tp_image_utils_functions::ExtractRect::extractRect(src->data,
+        outMember->data = tp_image_utils_functions::ExtractRect::extractRect(*src,
                                                                              x,
                                                                              y,
                                                                              width,
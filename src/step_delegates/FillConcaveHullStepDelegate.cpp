@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/FillConcaveHullStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
 #include "tp_image_utils_functions/FillConcaveHull.h"
@@ -29,13 +30,12 @@ void FillConcaveHullStepDelegate::executeStep(tp_pipeline::StepDetails* stepDeta
 
   params.solid = uint8_t(stepDetails->parameterValue<int>(solidSID()));
 
-  const tp_data_image_utils::ByteMapMember* src{nullptr};
-  input.memberCast(monoName, src);
+  auto src = findByteMap(input, monoName);
   if(src)
   {
     auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
-    outMember->data = tp_image_utils_functions::fillConcaveHull(src->data, params);
+    outMember->data = tp_image_utils_functions::fillConcaveHull(*src, params);
   }
 }
 
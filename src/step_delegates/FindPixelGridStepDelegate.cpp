@@ -1,4 +1,6 @@
 #include "tp_pipeline_image_utils/step_delegates/FindPixelGridStepDelegate.h"
+#include "tp_pipeline_image_utils/functions/PixelGrid.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
@@ -27,25 +29,45 @@ void FindPixelGridStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetail
   std::string  srcName = stepDetails->parameterValue<std::string>(gridSourceSID());
   std::string src2Name = stepDetails->parameterValue<std::string>(colorImageSID());
 
-  tp_data_image_utils::ByteMapMember*   src{nullptr};
-  tp_data_image_utils::ColorMapMember* src2{nullptr};
+  auto src = findByteMap(input, srcName);
 
-  input.memberCast( srcName,  src);
-  input.memberCast(src2Name, src2);
+  auto src2 = findColorMap(input, src2Name);
 
-  if(src)
+  if(src && src2 && (src->width()!=src2->width() || src->height()!=src2->height()))
   {
+    output.addError("The grid source and color image must be the same size.");
+    return;
+  }
+
+  if(src && stepDetails->parameterValue<std::string>(engineSID()) == "FFT")
+  {
+    PixelGridEstimate grid = estimatePixelGrid(*src);
     if(src2)
     {
       auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(outMember);
-      outMember->data = tp_image_utils_functions::FindPixelGrid::findPixelGrid(src->data, src2->data);
+      outMember->data = samplePixelGrid(*src2, grid);
     }
     else
     {
       auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(outMember);
-      outMember->data = tp_image_utils_functions::FindPixelGrid::findPixelGrid(src->data);
+      outMember->data = samplePixelGrid(*src, grid);
+    }
+  }
+  else if(src)
+  {
+    if(src2)
+    {
+      auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
+      output.addMember(outMember);
+      outMember->data = tp_image_utils_functions::FindPixelGrid::findPixelGrid(*src, *src2);
+    }
+    else
+    {
+      auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
+      output.addMember(outMember);
+      outMember->data = tp_image_utils_functions::FindPixelGrid::findPixelGrid(*src);
     }
   }
 }
@@ -78,6 +100,17 @@ void FindPixelGridStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDe
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = engineSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "FFT finds fractional cell sizes from the edge profiles and outputs one pixel per cell.";
+    param.setEnum({"Default", "FFT"});
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
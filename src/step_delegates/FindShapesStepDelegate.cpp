@@ -1,4 +1,9 @@
 #include "tp_pipeline_image_utils/step_delegates/FindShapesStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/functions/HoughLines.h"
+#include "tp_pipeline_image_utils/functions/JoinSegments.h"
+#include "tp_pipeline_image_utils/functions/Rasterise.h"
+#include "tp_pipeline_image_utils/members/FloatMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 #include "tp_data_image_utils/members/LineCollectionMember.h"
@@ -20,6 +25,49 @@
 namespace tp_pipeline_image_utils
 {
 
+namespace
+{
+//##################################################################################################
+tp_image_utils::LineCollection toLineCollection(const std::vector<LineSegment>& segments)
+{
+  tp_image_utils::LineCollection lines;
+  lines.reserve(segments.size());
+  for(const auto& segment : segments)
+  {
+    auto& line = lines.emplace_back();
+    line.push_back(tp_image_utils::Point(segment.x0, segment.y0));
+    line.push_back(tp_image_utils::Point(segment.x1, segment.y1));
+  }
+  return lines;
+}
+
+//##################################################################################################
+//! Polylines repeat the first point of closed loops, polygons list each corner once.
+tp_image_utils::LineCollection toLineCollection(const std::vector<Polyline>& polylines,
+                                                bool closedOnly,
+                                                size_t cornerCount,
+                                                bool repeatFirst)
+{
+  tp_image_utils::LineCollection lines;
+  for(const auto& polyline : polylines)
+  {
+    if(closedOnly && !polyline.closed)
+      continue;
+
+    if(cornerCount && polyline.points.size()!=cornerCount)
+      continue;
+
+    auto& line = lines.emplace_back();
+    for(const auto& p : polyline.points)
+      line.push_back(tp_image_utils::Point(p[0], p[1]));
+
+    if(repeatFirst && polyline.closed && !polyline.points.empty())
+      line.push_back(line.front());
+  }
+  return lines;
+}
+}
+
 //##################################################################################################
 FindShapesStepDelegate::FindShapesStepDelegate():
   AbstractStepDelegate(findShapesSID(), {findAndSegmentSID()})
@@ -38,17 +86,47 @@ void FindShapesStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
   std::string shapeType  = stepDetails->parameterValue<std::string>(       shapeTypeSID());
   float angleDeviation   = stepDetails->parameterValue<float>      (  angleDeviationSID());
   std::string debugImage = stepDetails->parameterValue<std::string>(  drawDebugImageSID());
+  bool hough             = stepDetails->parameterValue<std::string>(          engineSID()) == "Hough";
 
   std::string srcName    = stepDetails->parameterValue<std::string>(          sourceSID());
 
-  const tp_data_image_utils::ByteMapMember* src{nullptr};
-  input.memberCast(srcName, src);
+  auto src = findByteMap(input, srcName);
   if(!src)
   {
     output.addError("Failed to find input.");
     return;
   }
 
+  // The Hough segments are found once and shared by every shape type.
+  std::vector<LineSegment> segments;
+  if(hough)
+  {
+    HoughLineParameters params;
+    params.minPoints = size_t(minPoints);
+    params.maxDeviation = size_t(maxDeviation);
+    params.angleBins = size_t(stepDetails->parameterValue<int>("Angle bins"));
+
+    const FloatMapMember* orientation{nullptr};
+    input.memberCast(stepDetails->parameterValue<std::string>("Orientation"), orientation);
+    if(orientation)
+      params.orientation = &orientation->data;
+
+    segments = houghLines(*src, params);
+  }
+
+  auto findLines = [&]
+  {
+    if(!hough)
+      return tp_image_utils_functions::FindLines::findLines(*src, minPoints, maxDeviation);
+    return toLineCollection(segments);
+  };
+
+  // Polylines keep open chains as well as loops.
+  auto joinLines = [&](bool closedOnly, size_t cornerCount, bool repeatFirst)
+  {
+    return toLineCollection(joinSegments(segments, float(maxJointDistance)), closedOnly, cornerCount, repeatFirst);
+  };
+
   tp_image_utils::LineCollection lines;
   bool linesValid=false;
   tp_image_utils::LineCollection vLines;
@@ -59,27 +137,27 @@ void FindShapesStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   if(shapeType == "Lines")
   {
-    lines = tp_image_utils_functions::FindLines::findLines(src->data, minPoints, maxDeviation);
+    lines = findLines();
     linesValid=true;
   }
   else if(shapeType == "Polylines")
   {
-    lines = tp_image_utils_functions::FindLines::findPolylines(src->data, minPoints, maxDeviation, maxJointDistance);
+    lines = hough?joinLines(false, 0, true):tp_image_utils_functions::FindLines::findPolylines(*src, minPoints, maxDeviation, maxJointDistance);
     linesValid=true;
   }
   else if(shapeType == "Polygons")
   {
-    lines = tp_image_utils_functions::FindLines::findPolygons(src->data, minPoints, maxDeviation, maxJointDistance);
+    lines = hough?joinLines(true, 0, false):tp_image_utils_functions::FindLines::findPolygons(*src, minPoints, maxDeviation, maxJointDistance);
     linesValid=true;
   }
   else if(shapeType == "Quadrilaterals")
   {
-    lines = tp_image_utils_functions::FindLines::findQuadrilaterals(src->data, minPoints, maxDeviation, maxJointDistance);
+    lines = hough?joinLines(true, 4, false):tp_image_utils_functions::FindLines::findQuadrilaterals(*src, minPoints, maxDeviation, maxJointDistance);
     linesValid=true;
   }
   else if(shapeType == "Regular finite grid" || shapeType == "Regular infinite grid" || shapeType == "Distorted finite grid")
   {
-    lines = tp_image_utils_functions::FindLines::findLines(src->data, minPoints, maxDeviation);
+    lines = findLines();
     tp_image_utils_functions::FindPixelGrid::FindRegularGridParams params;
     params.hLines = &hLines;
     params.vLines = &vLines;
@@ -95,50 +173,34 @@ void FindShapesStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
     gridValid=true;
   }
 
-//  //-- Generate a debug image ----------------------------------------------------------------------
-//  if(debugImage == "Yes")
-//  {
-//    //tp_image_utils::ColorMap img = src->data.toImage();
-
-//    if(!lines.empty())
-//    {
-//      tp_image_utils::PointStyle style;
-//      style.lineColor = TPPixel(255, 0, 0);
-//      //img = tp_image_utils_functions::Point::drawPoints(img, lines, style);
-//    }
-
-//    if(!vLines.empty())
-//    {
-//      tp_image_utils::PointStyle style;
-//      style.lineColor = TPPixel(0, 255, 0);
-//      //img = tp_image_utils_functions::Point::drawPoints(img, vLines, style);
-//    }
-
-//    if(!hLines.empty())
-//    {
-//      tp_image_utils::PointStyle style;
-//      style.lineColor = TPPixel(0, 0, 255);
-//      //img = tp_image_utils_functions::Point::drawPoints(img, hLines, style);
-//    }
-
-//    if(gridValid)
-//    {
-//      tp_image_utils::GridStyle style;
-//      style.lineColor = TPPixel(255, 255, 0);
-//      //img = grid.drawGrid(img, style);
-//    }
-
-//    if(!distortedGrid.empty())
-//    {
-//      tp_image_utils::PointStyle style;
-//      style.lineColor = TPPixel(255, 0, 255);
-//      //img = tp_image_utils::Point::drawPoints(img, distortedGrid, style);
-//    }
-
-//    //auto outMember = new ColorMapMember(stepDetails->lookupOutputName("Output data"));
-//    //output.addMember(outMember);
-//    //outMember->data = img;
-//  }
+  //-- Generate a debug image ----------------------------------------------------------------------
+  if(debugImage == "Yes")
+  {
+    auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
+    output.addMember(outMember);
+    auto& img = outMember->data;
+
+    size_t w = src->width();
+    size_t h = src->height();
+    img.setSize(w, h);
+    {
+      const uint8_t* s = src->constData();
+      TPPixel* d = img.data();
+      for(size_t i=0; i<w*h; i++)
+        d[i] = TPPixel(s[i], s[i], s[i]);
+    }
+
+    LineBatch batch;
+    batch.addLines(lines, TPPixel(255, 0, 0));
+    batch.addLines(vLines, TPPixel(0, 255, 0));
+    batch.addLines(hLines, TPPixel(0, 0, 255));
+
+    if(gridValid)
+      batch.addGrid(grid, w, h, TPPixel(255, 255, 0));
+
+    batch.addLine(distortedGrid, TPPixel(255, 0, 255));
+    batch.draw(img);
+  }
 
   //-- Output the results --------------------------------------------------------------------------
   {
@@ -201,6 +263,46 @@ void FindShapesStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDetai
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = engineSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Hough finds line segments with a progressive probabilistic Hough transform and joins them into shapes.";
+    param.setEnum({"Default", "Hough"});
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
+  bool hough = (stepDetails->parameterValue<std::string>(engineSID()) == "Hough");
+
+  {
+    tp_utils::StringID name = "Angle bins";
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "The number of angles over 180 degrees that the Hough accumulator is divided into.";
+    param.type = tp_pipeline::intSID();
+    param.min = 4;
+    param.max = 3600;
+    param.validateBounds<int>(180);
+    param.enabled = hough;
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
+  {
+    tp_utils::StringID name = "Orientation";
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Optional gradient orientation from Edge detect, each pixel then only votes for lines close to its edge direction.";
+    param.type = tp_pipeline::namedDataSID();
+    param.enabled = hough;
+
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   {
     tp_utils::StringID name = drawDebugImageSID();
     auto param = tpGetMapValue(parameters, name);
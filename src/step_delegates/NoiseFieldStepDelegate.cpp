@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/NoiseFieldStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
 #include "tp_image_utils_functions/NoiseField.h"
@@ -37,13 +38,13 @@ void NoiseFieldStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   for(const auto& member : input.previousSteps.back()->members())
   {
-    auto byteMapMember = dynamic_cast<tp_data_image_utils::ByteMapMember*>(member);
-    if(!byteMapMember)
+    auto byteMap = byteMapFromMember(member);
+    if(!byteMap)
       continue;
 
     auto newByteMapMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(newByteMapMember);
-    newByteMapMember->data = tp_image_utils_functions::noiseFieldGrid(byteMapMember->data, cellSize);
+    newByteMapMember->data = tp_image_utils_functions::noiseFieldGrid(*byteMap, cellSize);
   }
 }
 
@@ -1,4 +1,6 @@
 #include "tp_pipeline_image_utils/step_delegates/NormalizeBrightnessStepDelegate.h"
+#include "tp_pipeline_image_utils/functions/LocalStatistics.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 
 #include "tp_image_utils_functions/NormalizeBrightness.h"
@@ -11,6 +13,33 @@
 namespace tp_pipeline_image_utils
 {
 
+namespace
+{
+//##################################################################################################
+enum class Engine_lt
+{
+  Default,
+  SlidingWindow
+};
+
+//##################################################################################################
+Engine_lt engineFromString(const std::string& engine)
+{
+  if(engine=="Sliding window") return Engine_lt::SlidingWindow;
+  return Engine_lt::Default;
+}
+
+//##################################################################################################
+bool localStatisticFromString(const std::string& shiftMode, LocalStatistic& statistic)
+{
+  if(shiftMode=="By mean")      {statistic = LocalStatistic::Mean;     return true;}
+  if(shiftMode=="By median")    {statistic = LocalStatistic::Median;   return true;}
+  if(shiftMode=="By mode")      {statistic = LocalStatistic::Mode;     return true;}
+  if(shiftMode=="By soft mode") {statistic = LocalStatistic::SoftMode; return true;}
+  return false;
+}
+}
+
 //##################################################################################################
 NormalizeBrightnessStepDelegate::NormalizeBrightnessStepDelegate():
   AbstractStepDelegate(normalizeBrightnessSID(), {processingSID()})
@@ -28,6 +57,9 @@ void NormalizeBrightnessStepDelegate::executeStep(tp_pipeline::StepDetails* step
   std::string mode_      = stepDetails->parameterValue<std::string>("Mode");
   std::string shiftMode_ = stepDetails->parameterValue<std::string>("Shift mode");
   int shiftValue         = stepDetails->parameterValue<int>        ("Shift value");
+  Engine_lt engine       = engineFromString(stepDetails->parameterValue<std::string>(engineSID()));
+
+  size_t radius = size_t(tpBound(1, paletteSize, 1000));
 
   if(input.previousSteps.empty())
   {
@@ -35,19 +67,40 @@ void NormalizeBrightnessStepDelegate::executeStep(tp_pipeline::StepDetails* step
     return;
   }
 
-  if(mode_ == "Shift brightness")
+  LocalStatistic statistic = LocalStatistic::Mean;
+  if(engine == Engine_lt::SlidingWindow && (mode_ != "Shift brightness" || localStatisticFromString(shiftMode_, statistic)))
+  {
+    for(const auto& member : input.previousSteps.back()->members())
+    {
+      auto colorMap = colorMapFromMember(member);
+      if(!colorMap)
+        continue;
+
+      auto newColorMapMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
+      output.addMember(newColorMapMember);
+      newColorMapMember->data = *colorMap;
+
+      if(mode_ == "Shift brightness")
+        shiftBrightnessLocal(newColorMapMember->data, radius, statistic, 128);
+      else if(mode_ == "Exaggerate")
+        normalizeBrightnessLocal(newColorMapMember->data, radius, exaggeration);
+      else
+        normalizeBrightnessLocal(newColorMapMember->data, radius, 0.0f);
+    }
+  }
+  else if(mode_ == "Shift brightness")
   {
     tp_image_utils_functions::ShiftBrightnessMode mode = tp_image_utils_functions::shiftBrightnessModeFromString(shiftMode_);
 
     for(const auto& member : input.previousSteps.back()->members())
     {
-      auto colorMapMember = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member);
-      if(!colorMapMember)
+      auto colorMap = colorMapFromMember(member);
+      if(!colorMap)
         continue;
 
       auto newColorMapMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(newColorMapMember);
-      newColorMapMember->data = colorMapMember->data;
+      newColorMapMember->data = *colorMap;
       tp_image_utils_functions::shiftBrightness(newColorMapMember->data, mode, uint8_t(shiftValue));
     }
   }
@@ -60,13 +113,13 @@ void NormalizeBrightnessStepDelegate::executeStep(tp_pipeline::StepDetails* step
 
     for(const auto& member : input.previousSteps.back()->members())
     {
-      auto colorMapMember = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member);
-      if(!colorMapMember)
+      auto colorMap = colorMapFromMember(member);
+      if(!colorMap)
         continue;
 
       auto newColorMapMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(newColorMapMember);
-      newColorMapMember->data = colorMapMember->data;
+      newColorMapMember->data = *colorMap;
       tp_image_utils_functions::normalizeBrightness(newColorMapMember->data, paletteSize, mode, exaggeration);
     }
   }
@@ -143,6 +196,16 @@ void NormalizeBrightnessStepDelegate::fixupParameters(tp_pipeline::StepDetails*
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = engineSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Sliding window uses local statistics around each pixel, the cost does not grow with the radius.";
+    param.setEnum({"Default", "Sliding window"});
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
@@ -1,4 +1,6 @@
 #include "tp_pipeline_image_utils/step_delegates/PixelManipulationStepDelegate.h"
+#include "tp_pipeline_image_utils/functions/PixelManipulation.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
@@ -26,6 +28,34 @@ OutMode_lt outModeFromString(const std::string& mode)
   if(mode=="Color") return OutMode_lt::Color        ;
   return OutMode_lt::Byte;
 }
+
+//##################################################################################################
+//! Parse "alias=member name" pairs separated by commas or new lines.
+std::vector<std::pair<std::string, std::string>> parseNamedInputs(const std::string& text)
+{
+  auto trim = [](const std::string& s)
+  {
+    size_t b = s.find_first_not_of(" \t\r");
+    size_t e = s.find_last_not_of(" \t\r");
+    return (b==std::string::npos)?std::string():s.substr(b, e-b+1);
+  };
+
+  std::vector<std::pair<std::string, std::string>> result;
+  size_t pos=0;
+  while(pos<=text.size())
+  {
+    size_t end = text.find_first_of(",\n", pos);
+    if(end==std::string::npos)
+      end = text.size();
+
+    std::string item = text.substr(pos, end-pos);
+    if(auto eq = item.find('='); eq!=std::string::npos)
+      result.emplace_back(trim(item.substr(0, eq)), trim(item.substr(eq+1)));
+
+    pos = end+1;
+  }
+  return result;
+}
 }
 
 //##################################################################################################
@@ -52,46 +82,97 @@ void PixelManipulationStepDelegate::executeStep(tp_pipeline::StepDetails* stepDe
   params.calcAlpha = stepDetails->parameterValue<std::string>(calcAlphaSID());
   params.calcByte  = stepDetails->parameterValue<std::string>(calcByteSID ());
 
+  auto namedInputNames = parseNamedInputs(stepDetails->parameterValue<std::string>(namedInputsSID()));
+
+  PixelExpressions expressions;
+  expressions.calcRed   = params.calcRed;
+  expressions.calcGreen = params.calcGreen;
+  expressions.calcBlue  = params.calcBlue;
+  expressions.calcAlpha = params.calcAlpha;
+  expressions.calcByte  = params.calcByte;
+
   std::vector<std::string> errors;
 
+  //-- Extra images that the compiled expressions can read by alias --------------------------------
+  std::vector<PixelInput> namedInputs;
+  std::vector<std::shared_ptr<const tp_image_utils::ColorMap>> namedColors;
+  std::vector<std::shared_ptr<const tp_image_utils::ByteMap>> namedBytes;
+  for(const auto& [alias, memberName] : namedInputNames)
+  {
+    if(auto color = findColorMap(input, memberName); color)
+    {
+      namedInputs.emplace_back(alias, color.get());
+      namedColors.push_back(color);
+      continue;
+    }
+
+    if(auto byte = findByteMap(input, memberName); byte)
+    {
+      namedInputs.emplace_back(alias, byte.get());
+      namedBytes.push_back(byte);
+    }
+    else
+      output.addError("Failed to find named input: " + memberName);
+  }
+
+  // Expressions are compiled, syntax that the compiler does not support falls back to the
+  // tp_image_utils_functions evaluator, which can only read a single source.
   auto process = [&](auto src)
   {
+    std::vector<PixelInput> inputs;
+    if(src)
+      inputs.emplace_back(std::string(), src);
+    inputs.insert(inputs.end(), namedInputs.begin(), namedInputs.end());
+
+    std::vector<std::string> compileErrors;
+    auto fallback = [&]
+    {
+      if(compileErrors.empty())
+        return false;
+      if(src && namedInputs.empty())
+        return true;
+      errors.insert(errors.end(), compileErrors.begin(), compileErrors.end());
+      return false;
+    };
+
     if(outMode == OutMode_lt::Color)
     {
       auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(outMember);
-      outMember->data = tp_image_utils_functions::pixelManipulationColor(src->data, params, errors);
+      outMember->data = compiledPixelManipulationColor(inputs, expressions, compileErrors);
+      if(fallback())
+        outMember->data = tp_image_utils_functions::pixelManipulationColor(*src, params, errors);
     }
     else
     {
       auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(outMember);
-      outMember->data = tp_image_utils_functions::pixelManipulationByte(src->data, params, errors);
+      outMember->data = compiledPixelManipulationByte(inputs, expressions, compileErrors);
+      if(fallback())
+        outMember->data = tp_image_utils_functions::pixelManipulationByte(*src, params, errors);
     }
   };
 
   if(!colorName.empty())
   {
-    const tp_data_image_utils::ColorMapMember* src{nullptr};
-    input.memberCast(colorName, src);
-
-    if(src)
-      process(src);
+    if(auto src = findColorMap(input, colorName); src)
+      process(src.get());
     else
       output.addError("Failed to find source color image.");
   }
 
   if(!grayName.empty())
   {
-    const tp_data_image_utils::ByteMapMember* src{nullptr};
-    input.memberCast(grayName, src);
-
-    if(src)
-      process(src);
+    if(auto src = findByteMap(input, grayName); src)
+      process(src.get());
     else
       output.addError("Failed to find source gray image.");
   }
 
+  // With only named inputs everything is read through an alias.
+  if(colorName.empty() && grayName.empty() && !namedInputs.empty())
+    process(static_cast<const tp_image_utils::ColorMap*>(nullptr));
+
   for(const auto& error : errors)
     output.addError(error);
 }
@@ -117,6 +198,17 @@ void PixelManipulationStepDelegate::fixupParameters(tp_pipeline::StepDetails* st
 
   OutMode_lt outMode = outModeFromString(stepDetails->parameterValue<std::string>(modeSID()));
 
+  {
+    const tp_utils::StringID& name = namedInputsSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Extra images as alias=name pairs, read them in expressions as alias.red, alias.byte etc.";
+    param.type = tp_pipeline::stringSID();
+    param.value = tpGetVariantValue<std::string>(param.value, "");
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   {
     const tp_utils::StringID& name = calcRedSID();
     auto param = tpGetMapValue(parameters, name);
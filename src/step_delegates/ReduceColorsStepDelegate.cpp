@@ -1,4 +1,7 @@
 #include "tp_pipeline_image_utils/step_delegates/ReduceColorsStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
+#include "tp_pipeline_image_utils/members/IndexedImageMember.h"
+#include "tp_pipeline_image_utils/functions/Palette.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 
 #include "tp_image_utils_functions/ReduceColors.h"
@@ -8,6 +11,8 @@
 
 #include "tp_data/Collection.h"
 
+#include "tp_utils/DebugUtils.h"
+
 namespace tp_pipeline_image_utils
 {
 
@@ -26,6 +31,7 @@ void ReduceColorsStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails
   std::shared_ptr<tp_data::Collection> results;
 
   int paletteSize = stepDetails->parameterValue<int>("Palette size");
+  bool indexed = (stepDetails->parameterValue<std::string>(outputFormatSID()) == "Indexed");
 
   if(input.previousSteps.empty())
   {
@@ -35,13 +41,26 @@ void ReduceColorsStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails
 
   for(const auto& member : input.previousSteps.back()->members())
   {
-    auto byteMapMember = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member);
-    if(!byteMapMember)
+    auto colorMap = colorMapFromMember(member);
+    if(!colorMap)
       continue;
 
+    if(indexed)
+    {
+      if(paletteSize<=256)
+      {
+        auto indexedMember = new IndexedImageMember(stepDetails->lookupOutputName("Output data"));
+        output.addMember(indexedMember);
+        quantizeColors(*colorMap, size_t(paletteSize), indexedMember->indices, indexedMember->palette);
+        continue;
+      }
+
+      tpWarning() << "ReduceColors: more than 256 colors, falling back to color output.";
+    }
+
     auto newByteMapMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(newByteMapMember);
-    newByteMapMember->data = tp_image_utils_functions::reduceColors(byteMapMember->data, paletteSize);
+    newByteMapMember->data = tp_image_utils_functions::reduceColors(*colorMap, paletteSize);
   }
 }
 
@@ -71,6 +90,16 @@ void ReduceColorsStepDelegate::fixupParameters(tp_pipeline::StepDetails* stepDet
     validParams.push_back(name);
   }
 
+  {
+    tp_utils::StringID name = outputFormatSID();
+    auto param = tpGetMapValue(parameters, name);
+    param.name = name;
+    param.description = "Indexed writes palette indices using a median cut palette of up to 256 colors.";
+    param.setEnum({"Color", "Indexed"});
+    stepDetails->setParamerter(param);
+    validParams.push_back(name);
+  }
+
   stepDetails->setParametersOrder(validParams);
   stepDetails->setValidParameters(validParams);
 }
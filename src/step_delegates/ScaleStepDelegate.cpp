@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/ScaleStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 
 #include "tp_image_utils/Scale.h"
@@ -191,14 +192,12 @@ void ScaleStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   if(!colorImageName.empty())
   {
-    const tp_data_image_utils::ColorMapMember* src{nullptr};
-    input.memberCast(colorImageName, src);
-    if(src)
+    if(auto src = findColorMap(input, colorImageName); src)
     {
       auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(outMember);
-      std::pair<size_t, size_t> calculatedSize = calculateSize(sizeCalculation, size, width, height, src->data.width(), src->data.height());
-      outMember->data = tp_image_utils::scale(src->data, calculatedSize.first, calculatedSize.second);
+      std::pair<size_t, size_t> calculatedSize = calculateSize(sizeCalculation, size, width, height, src->width(), src->height());
+      outMember->data = tp_image_utils::scale(*src, calculatedSize.first, calculatedSize.second);
     }
     else
     {
@@ -208,14 +207,12 @@ void ScaleStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   if(!byteMapName.empty())
   {
-    const tp_data_image_utils::ColorMapMember* src{nullptr};
-    input.memberCast(byteMapName, src);
-    if(src)
+    if(auto src = findColorMap(input, byteMapName); src)
     {
       auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
       output.addMember(outMember);
-      std::pair<size_t, size_t> calculatedSize = calculateSize(sizeCalculation, size, width, height, src->data.width(), src->data.height());
-      outMember->data = tp_image_utils::scale(src->data, calculatedSize.first, calculatedSize.second);
+      std::pair<size_t, size_t> calculatedSize = calculateSize(sizeCalculation, size, width, height, src->width(), src->height());
+      outMember->data = tp_image_utils::scale(*src, calculatedSize.first, calculatedSize.second);
     }
     else
     {
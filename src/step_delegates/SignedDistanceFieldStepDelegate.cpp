@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/SignedDistanceFieldStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
 #include "tp_image_utils_functions/SignedDistanceField.h"
@@ -39,17 +40,17 @@ void SignedDistanceFieldStepDelegate::executeStep(tp_pipeline::StepDetails* step
 
   for(const auto& member : input.previousSteps.back()->members())
   {
-    auto byteMapMember = dynamic_cast<tp_data_image_utils::ByteMapMember*>(member);
-    if(!byteMapMember)
+    auto byteMap = byteMapFromMember(member);
+    if(!byteMap)
       continue;
 
     auto newByteMapMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(newByteMapMember);
 
     if(width>0 && height>0)
-      newByteMapMember->data = tp_image_utils_functions::signedDistanceField(byteMapMember->data, radius, width, height);
+      newByteMapMember->data = tp_image_utils_functions::signedDistanceField(*byteMap, radius, width, height);
     else
-      newByteMapMember->data = tp_image_utils_functions::signedDistanceField(byteMapMember->data, radius);
+      newByteMapMember->data = tp_image_utils_functions::signedDistanceField(*byteMap, radius);
   }
 }
 
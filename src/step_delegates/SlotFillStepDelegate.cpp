@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/SlotFillStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
 #include "tp_image_utils_functions/SlotFill.h"
@@ -41,13 +42,12 @@ void SlotFillStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
   params.maxAngle   = tpBound(size_t(1), stepDetails->parameterValue<size_t>(  maxAngleSID()), size_t( 90));
   params.stepAngle  = tpBound(size_t(1), stepDetails->parameterValue<size_t>( stepAngleSID()), size_t( 90));
 
-  const tp_data_image_utils::ByteMapMember* src{nullptr};
-  input.memberCast(monoName, src);
+  auto src = findByteMap(input, monoName);
   if(src)
   {
     auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
-    outMember->data = tp_image_utils_functions::slotFill(src->data, params);
+    outMember->data = tp_image_utils_functions::slotFill(*src, params);
   }
 }
 
@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/ToFloatStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 
 #include "tp_data_math_utils/members/FloatsMember.h"
@@ -78,21 +79,18 @@ void ToFloatStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
   auto channelMode  =  tp_image_utils_functions::channelModeFromString(stepDetails->parameterValue<std::string>( channelModeSID()));
   auto channelOrder = tp_image_utils_functions::channelOrderFromString(stepDetails->parameterValue<std::string>(channelOrderSID()));
 
-  auto processColor = [&](const tp_data_image_utils::ColorMapMember* src)
+  auto processColor = [&](const tp_image_utils::ColorMap& src)
   {
     auto outMember = new tp_data_math_utils::FloatsMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
 
-    tp_image_utils_functions::toFloat(src->data, channelMode, channelOrder, outMember->data);
+    tp_image_utils_functions::toFloat(src, channelMode, channelOrder, outMember->data);
   };
 
   if(!colorName.empty())
   {
-    const tp_data_image_utils::ColorMapMember* src{nullptr};
-    input.memberCast(colorName, src);
-
-    if(src)
-      processColor(src);
+    if(auto src = findColorMap(input, colorName); src)
+      processColor(*src);
     else
       output.addError("Failed to find source color image.");
   }
@@ -106,8 +104,8 @@ void ToFloatStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
     for(const auto& member : input.previousSteps.back()->members())
     {
-      if(auto color = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member); color)
-        processColor(color);
+      if(auto color = colorMapFromMember(member); color)
+        processColor(*color);
     }
   }
 }
@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/ToGrayStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
@@ -26,20 +27,17 @@ void ToGrayStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 {
   std::string colorName = stepDetails->parameterValue<std::string>(colorImageSID());  
 
-  auto processColor = [&](const tp_data_image_utils::ColorMapMember* src)
+  auto processColor = [&](const tp_image_utils::ColorMap& src)
   {
     auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
-    outMember->data = tp_image_utils::toGray(src->data);
+    outMember->data = tp_image_utils::toGray(src);
   };
 
   if(!colorName.empty())
   {
-    const tp_data_image_utils::ColorMapMember* src{nullptr};
-    input.memberCast(colorName, src);
-
-    if(src)
-      processColor(src);
+    if(auto src = findColorMap(input, colorName); src)
+      processColor(*src);
     else
       output.addError("Failed to find source color image.");
   }
@@ -53,8 +51,8 @@ void ToGrayStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
     for(const auto& member : input.previousSteps.back()->members())
     {
-      if(auto color = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member); color)
-        processColor(color);
+      if(auto color = colorMapFromMember(member); color)
+        processColor(*color);
     }
   }
 }
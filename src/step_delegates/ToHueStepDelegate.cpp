@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/ToHueStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
@@ -36,18 +37,18 @@ void ToHueStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
     for(const auto& member : input.previousSteps.back()->members())
     {
-      if(auto color = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member); color)
+      if(auto color = colorMapFromMember(member); color)
       {
         auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
         output.addMember(outMember);
-        outMember->data = tp_image_utils_functions::toHue(color->data);
+        outMember->data = tp_image_utils_functions::toHue(*color);
       }
 
-      else if(auto gray = dynamic_cast<tp_data_image_utils::ByteMapMember*>(member); gray)
+      else if(auto gray = byteMapFromMember(member); gray)
       {
         auto outMember = new tp_data_image_utils::ColorMapMember(stepDetails->lookupOutputName("Output data"));
         output.addMember(outMember);
-        outMember->data = tp_image_utils_functions::toHue(gray->data);
+        outMember->data = tp_image_utils_functions::toHue(*gray);
       }
     }
   }
@@ -61,11 +62,11 @@ void ToHueStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
     for(const auto& member : input.previousSteps.back()->members())
     {
-      if(auto color = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member); color)
+      if(auto color = colorMapFromMember(member); color)
       {
         auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
         output.addMember(outMember);
-        outMember->data = tp_image_utils_functions::toHueGray(color->data);
+        outMember->data = tp_image_utils_functions::toHueGray(*color);
       }
     }
   }
@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/ToMonoStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
@@ -34,38 +35,32 @@ void ToMonoStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
   colorThreshold = tpBound(1, colorThreshold, 767);
   monoThreshold = tpBound(1, monoThreshold, 254);
 
-  auto processColor = [&](const tp_data_image_utils::ColorMapMember* src)
+  auto processColor = [&](const tp_image_utils::ColorMap& src)
   {
     auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
-    outMember->data = tp_image_utils::toMono(src->data, colorThreshold);
+    outMember->data = tp_image_utils::toMono(src, colorThreshold);
   };
 
-  auto processGray = [&](const tp_data_image_utils::ByteMapMember* src)
+  auto processGray = [&](const tp_image_utils::ByteMap& src)
   {
     auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
-    outMember->data = tp_image_utils::toMono(src->data, uint8_t(monoThreshold));
+    outMember->data = tp_image_utils::toMono(src, uint8_t(monoThreshold));
   };
 
   if(!colorName.empty())
   {
-    const tp_data_image_utils::ColorMapMember* src{nullptr};
-    input.memberCast(colorName, src);
-
-    if(src)
-      processColor(src);
+    if(auto src = findColorMap(input, colorName); src)
+      processColor(*src);
     else
       output.addError("Failed to find source color image.");
   }
 
   if(!grayName.empty())
   {
-    const tp_data_image_utils::ByteMapMember* src{nullptr};
-    input.memberCast(grayName, src);
-
-    if(src)
-      processGray(src);
+    if(auto src = findByteMap(input, grayName); src)
+      processGray(*src);
     else
       output.addError("Failed to find source gray image.");
   }
@@ -80,11 +75,11 @@ void ToMonoStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
     for(const auto& member : input.previousSteps.back()->members())
     {
-      if(auto color = dynamic_cast<tp_data_image_utils::ColorMapMember*>(member); color)
-        processColor(color);
+      if(auto color = colorMapFromMember(member); color)
+        processColor(*color);
 
-      else if(auto gray = dynamic_cast<tp_data_image_utils::ByteMapMember*>(member); gray)
-        processGray(gray);
+      else if(auto gray = byteMapFromMember(member); gray)
+        processGray(*gray);
     }
   }
 }
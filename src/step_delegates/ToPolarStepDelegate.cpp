@@ -1,4 +1,5 @@
 #include "tp_pipeline_image_utils/step_delegates/ToPolarStepDelegate.h"
+#include "tp_pipeline_image_utils/ImageMembers.h"
 #include "tp_data_image_utils/members/ColorMapMember.h"
 #include "tp_data_image_utils/members/ByteMapMember.h"
 
@@ -29,20 +30,17 @@ void ToPolarStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
   std::string grayName  = stepDetails->parameterValue<std::string>(grayImageSID());
 
-  auto processGray = [&](const tp_data_image_utils::ByteMapMember* src)
+  auto processGray = [&](const tp_image_utils::ByteMap& src)
   {
     auto outMember = new tp_data_image_utils::ByteMapMember(stepDetails->lookupOutputName("Output data"));
     output.addMember(outMember);
-    outMember->data = tp_image_utils_functions::toPolar(src->data, w, h);
+    outMember->data = tp_image_utils_functions::toPolar(src, w, h);
   };
 
   if(!grayName.empty())
   {
-    const tp_data_image_utils::ByteMapMember* src{nullptr};
-    input.memberCast(grayName, src);
-
-    if(src)
-      processGray(src);
+    if(auto src = findByteMap(input, grayName); src)
+      processGray(*src);
     else
       output.addError("Failed to find source gray image.");
   }
@@ -56,8 +54,8 @@ void ToPolarStepDelegate::executeStep(tp_pipeline::StepDetails* stepDetails,
 
     for(const auto& member : input.previousSteps.back()->members())
     {
-      if(auto gray = dynamic_cast<tp_data_image_utils::ByteMapMember*>(member); gray)
-        processGray(gray);
+      if(auto gray = byteMapFromMember(member); gray)
+        processGray(*gray);
     }
   }
 }
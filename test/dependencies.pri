@@ -0,0 +1 @@
+DEPENDENCIES += tp_pipeline_image_utils
@@ -0,0 +1,91 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/Bitwise.h"
+
+#include <algorithm>
+
+namespace tp_pipeline_image_utils_test
+{
+
+namespace
+{
+//##################################################################################################
+//! Apply a truth table one bit at a time.
+uint8_t referenceBits(uint8_t p, uint8_t q, tp_pipeline_image_utils::TruthTable table)
+{
+  uint8_t result=0;
+  for(int bit=0; bit<8; bit++)
+  {
+    int index = (((p>>bit)&1)<<1) | ((q>>bit)&1);
+    result |= uint8_t(((table>>index)&1)<<bit);
+  }
+  return result;
+}
+
+//##################################################################################################
+tp_image_utils::ByteMap randomByteMap(size_t w, size_t h, uint32_t& seed)
+{
+  tp_image_utils::ByteMap map;
+  map.setSize(w, h);
+  for(size_t i=0; i<map.size(); i++)
+  {
+    seed = seed*1664525u + 1013904223u;
+    map.data()[i] = uint8_t(seed>>24);
+  }
+  return map;
+}
+}
+
+//##################################################################################################
+void bitwiseTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  uint32_t seed=3;
+
+  // Every table matches a bit by bit evaluation, including the bytes after the last whole word.
+  for(size_t w : {1, 7, 8, 61, 1031})
+  {
+    tp_image_utils::ByteMap p = randomByteMap(w, 37, seed);
+    tp_image_utils::ByteMap q0 = randomByteMap(w, 37, seed);
+    tp_image_utils::ByteMap q1 = randomByteMap(w, 37, seed);
+
+    for(TruthTable table=0; table<16; table++)
+    {
+      tp_image_utils::ByteMap dst = p;
+      bitwiseInPlace(dst, {&q0, &q1}, table);
+
+      bool same=true;
+      for(size_t i=0; i<p.size(); i++)
+      {
+        uint8_t expected = referenceBits(referenceBits(p.constData()[i], q0.constData()[i], table), q1.constData()[i], table);
+        same = same && dst.constData()[i]==expected;
+      }
+      TP_CHECK(same);
+    }
+  }
+
+  // Every listed operation maps to a truth table that gives the same result as bitwise().
+  tp_image_utils::ByteMap p = randomByteMap(131, 17, seed);
+  tp_image_utils::ByteMap q = randomByteMap(131, 17, seed);
+  for(const auto& name : tp_image_utils_functions::logicalOps())
+  {
+    auto operation = tp_image_utils_functions::logicOpFromString(name);
+
+    TruthTable table{0};
+    bool mapped = truthTable(operation, table);
+    TP_CHECK(mapped);
+    if(!mapped)
+    {
+      std::cerr << "No truth table for: " << name << std::endl;
+      continue;
+    }
+
+    tp_image_utils::ByteMap dst = p;
+    bitwiseInPlace(dst, {&q}, table);
+    tp_image_utils::ByteMap expected = tp_image_utils_functions::bitwise(p, q, operation);
+    TP_CHECK(dst.size()==expected.size() && std::equal(dst.constData(), dst.constData()+dst.size(), expected.constData()));
+  }
+}
+
+}
@@ -0,0 +1,122 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/CellSegment.h"
+
+namespace tp_pipeline_image_utils_test
+{
+
+namespace
+{
+//##################################################################################################
+//! Serial pass by pass growth, each unlabelled pixel takes the lowest label of its neighbours.
+std::vector<uint32_t> referenceGrowth(const tp_image_utils::ByteMap& src,
+                                      std::vector<uint32_t> labels,
+                                      size_t passes,
+                                      tp_pipeline_image_utils::CellGrowth growth)
+{
+  int64_t w = int64_t(src.width());
+  int64_t h = int64_t(src.height());
+  const uint8_t* fg = src.constData();
+
+  for(size_t p=0; p<passes; p++)
+  {
+    std::vector<uint32_t> previous = labels;
+    for(int64_t y=0; y<h; y++)
+    {
+      for(int64_t x=0; x<w; x++)
+      {
+        size_t i = size_t(y*w+x);
+        if(!fg[i] || previous[i])
+          continue;
+
+        uint32_t lowest=0;
+        for(int64_t dy=-1; dy<=1; dy++)
+        {
+          for(int64_t dx=-1; dx<=1; dx++)
+          {
+            if((dx==0 && dy==0) || (growth==tp_pipeline_image_utils::CellGrowth::Flood && dx!=0 && dy!=0))
+              continue;
+
+            int64_t nx=x+dx;
+            int64_t ny=y+dy;
+            if(nx<0 || ny<0 || nx>=w || ny>=h)
+              continue;
+
+            uint32_t l = previous[size_t(ny*w+nx)];
+            if(l && (!lowest || l<lowest))
+              lowest = l;
+          }
+        }
+        labels[i] = lowest;
+      }
+    }
+  }
+
+  return labels;
+}
+}
+
+//##################################################################################################
+void cellSegmentTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  tp_image_utils::ByteMap src;
+  src.setSize(151, 97);
+
+  uint32_t seed=7;
+  auto random = [&]{seed = seed*1664525u + 1013904223u; return seed>>8;};
+
+  // Mostly foreground with scattered background walls so cells meet and compete.
+  for(size_t i=0; i<src.size(); i++)
+    src.data()[i] = (random()%7)?255:0;
+
+  LabelMap seeds;
+  seeds.width = src.width();
+  seeds.height = src.height();
+  seeds.labels.assign(src.size(), 0);
+  for(uint32_t l=1; l<=300; l++)
+    seeds.labels[random()%src.size()] = l;
+
+  std::vector<uint32_t> start(src.size(), 0);
+  for(size_t i=0; i<src.size(); i++)
+    if(src.constData()[i])
+      start[i] = seeds.labels[i];
+
+  // The frontier growth matches a serial pass by pass growth on any number of threads.
+  for(auto growth : {CellGrowth::Box, CellGrowth::Flood})
+  {
+    for(size_t passes : {0, 1, 3, 40, 500})
+    {
+      FrontierCellSegmentParameters params;
+      params.growth = growth;
+      params.growCellsPasses = passes;
+
+      LabelMap result = frontierCellSegment(src, &seeds, params);
+      TP_CHECK(result.width==src.width() && result.height==src.height());
+      TP_CHECK(result.labels==referenceGrowth(src, start, passes, growth));
+    }
+  }
+
+  // Byte output clamps labels above 255.
+  FrontierCellSegmentParameters params;
+  LabelMap result = frontierCellSegment(src, &seeds, params);
+  tp_image_utils::ByteMap bytes = toByteMap(result);
+  bool clamped=true;
+  for(size_t i=0; i<result.labels.size(); i++)
+    clamped = clamped && bytes.constData()[i]==uint8_t(tpMin(result.labels[i], uint32_t(255)));
+  TP_CHECK(clamped);
+
+  // Seeding from the distance field is repeatable and only labels foreground.
+  params.minRadius = 2;
+  params.maxInitialCells = 1000;
+  LabelMap first = frontierCellSegment(src, nullptr, params);
+  LabelMap second = frontierCellSegment(src, nullptr, params);
+  TP_CHECK(first.labels==second.labels);
+  bool foreground=true;
+  for(size_t i=0; i<src.size(); i++)
+    foreground = foreground && (src.constData()[i] || !first.labels[i]);
+  TP_CHECK(foreground);
+}
+
+}
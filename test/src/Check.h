@@ -0,0 +1,59 @@
+#ifndef tp_pipeline_image_utils_test_Check_h
+#define tp_pipeline_image_utils_test_Check_h
+
+#include <iostream>
+
+namespace tp_pipeline_image_utils_test
+{
+
+//##################################################################################################
+//! The number of failed checks, main() returns non zero if this is set.
+int& failures();
+
+//##################################################################################################
+#define TP_CHECK(condition) \
+  do \
+  { \
+    if(!(condition)) \
+    { \
+      tp_pipeline_image_utils_test::failures()++; \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+    } \
+  } while(false)
+
+//##################################################################################################
+void bitwiseTest();
+
+//##################################################################################################
+void cellSegmentTest();
+
+//##################################################################################################
+void contoursTest();
+
+//##################################################################################################
+void drawMaskTest();
+
+//##################################################################################################
+void expressionTest();
+
+//##################################################################################################
+void gradientTest();
+
+//##################################################################################################
+void localStatisticsTest();
+
+//##################################################################################################
+void paletteTest();
+
+//##################################################################################################
+void parallelTest();
+
+//##################################################################################################
+void pixelGridTest();
+
+//##################################################################################################
+void rasteriseTest();
+
+}
+
+#endif
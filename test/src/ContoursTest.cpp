@@ -0,0 +1,156 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/Contours.h"
+
+#include <algorithm>
+
+namespace tp_pipeline_image_utils_test
+{
+
+namespace
+{
+using Contour = std::vector<std::array<float, 2>>;
+
+//##################################################################################################
+//! Breadth first fill of 4 connected regions, numbered in raster order from 1.
+std::vector<uint32_t> referenceComponents(const tp_image_utils::ByteMap& src, size_t& count)
+{
+  auto w = int64_t(src.width());
+  auto h = int64_t(src.height());
+  const uint8_t* s = src.constData();
+
+  std::vector<uint32_t> components(src.size(), 0);
+  std::vector<int64_t> queue;
+  count=0;
+  for(int64_t i=0; i<w*h; i++)
+  {
+    if(!s[i] || components[size_t(i)])
+      continue;
+
+    auto component = uint32_t(++count);
+    components[size_t(i)] = component;
+    queue.assign(1, i);
+    while(!queue.empty())
+    {
+      int64_t p = queue.back();
+      queue.pop_back();
+      int64_t x = p%w;
+      int64_t y = p/w;
+      for(auto [dx, dy] : {std::pair<int64_t, int64_t>{-1, 0}, {1, 0}, {0, -1}, {0, 1}})
+      {
+        int64_t nx = x+dx;
+        int64_t ny = y+dy;
+        int64_t n = ny*w+nx;
+        if(nx<0 || ny<0 || nx>=w || ny>=h || s[n]!=s[i] || components[size_t(n)])
+          continue;
+        components[size_t(n)] = component;
+        queue.push_back(n);
+      }
+    }
+  }
+  return components;
+}
+
+//##################################################################################################
+//! Even odd test of a point against a closed contour.
+bool inside(const Contour& contour, float px, float py)
+{
+  bool result=false;
+  for(size_t i=0, j=contour.size()-1; i<contour.size(); j=i++)
+  {
+    const auto& a = contour[i];
+    const auto& b = contour[j];
+    if((a[1]>py) != (b[1]>py) && px < (b[0]-a[0])*(py-a[1])/(b[1]-a[1]) + a[0])
+      result = !result;
+  }
+  return result;
+}
+}
+
+//##################################################################################################
+void contoursTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  // Blocks of random labels with single pixel noise give touching regions, holes and diagonals.
+  tp_image_utils::ByteMap src;
+  src.setSize(70, 83);
+  uint32_t seed=21;
+  auto random = [&]{seed = seed*1664525u + 1013904223u; return seed>>8;};
+  std::vector<uint8_t> blocks(18*21);
+  for(auto& b : blocks)
+    b = uint8_t(random()%3);
+  for(size_t y=0; y<src.height(); y++)
+    for(size_t x=0; x<src.width(); x++)
+      src.data()[y*src.width()+x] = (random()%11)?blocks[(y/4)*18 + x/4]:uint8_t(random()%3);
+
+  // A ring with a hole that holds an island.
+  for(size_t y=30; y<45; y++)
+    for(size_t x=30; x<45; x++)
+      src.data()[y*src.width()+x] = (x>=33 && x<42 && y>=33 && y<42)?((x>=36 && x<39 && y>=36 && y<39)?2:0):1;
+
+  //-- Union find labelling matches a flood fill ---------------------------------------------------
+  size_t count=0;
+  size_t expectedCount=0;
+  std::vector<uint32_t> components = labelComponents(src, count);
+  std::vector<uint32_t> expected = referenceComponents(src, expectedCount);
+  TP_CHECK(count==expectedCount);
+  TP_CHECK(components==expected);
+
+  //-- Each polygon covers the centers of exactly the pixels of one region -------------------------
+  std::vector<LabelPolygon> polygons = traceLabelPolygons(src, 0.0f);
+  TP_CHECK(polygons.size()==expectedCount);
+
+  size_t holes=0;
+  std::vector<uint8_t> covered(expectedCount+1, 0);
+  bool exact=true;
+  for(const auto& polygon : polygons)
+  {
+    holes += polygon.holes.size();
+
+    uint32_t component=0;
+    uint8_t label=0;
+    size_t mismatches=0;
+    for(size_t y=0; y<src.height(); y++)
+    {
+      for(size_t x=0; x<src.width(); x++)
+      {
+        float px = float(x)+0.5f;
+        float py = float(y)+0.5f;
+        bool in = inside(polygon.outline, px, py);
+        for(const auto& hole : polygon.holes)
+          in = in && !inside(hole, px, py);
+
+        uint32_t c = expected[y*src.width()+x];
+        if(in && !component)
+        {
+          component = c;
+          label = src.constData()[y*src.width()+x];
+        }
+
+        if(in != (c && c==component))
+          mismatches++;
+      }
+    }
+
+    exact = exact && mismatches==0 && component && polygon.label==label;
+    if(component && component<covered.size())
+      covered[component]++;
+  }
+  TP_CHECK(exact);
+  TP_CHECK(std::all_of(covered.begin()+1, covered.end(), [](uint8_t c){return c==1;}));
+  TP_CHECK(holes>0);
+
+  //-- Simplification keeps every region and never adds vertices -----------------------------------
+  std::vector<LabelPolygon> simplified = traceLabelPolygons(src, 1.5f);
+  TP_CHECK(simplified.size()==polygons.size());
+  size_t before=0;
+  size_t after=0;
+  for(const auto& polygon : polygons)
+    before += polygon.outline.size();
+  for(const auto& polygon : simplified)
+    after += polygon.outline.size();
+  TP_CHECK(after<before);
+}
+
+}
@@ -0,0 +1,86 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/DrawMask.h"
+
+namespace tp_pipeline_image_utils_test
+{
+
+namespace
+{
+//##################################################################################################
+uint8_t blendChannel(uint8_t dst, uint8_t src, uint8_t opacity)
+{
+  uint32_t alpha = uint32_t(opacity) + (uint32_t(opacity)>>7);
+  return uint8_t((uint32_t(src)*alpha + uint32_t(dst)*(256-alpha)) >> 8);
+}
+}
+
+//##################################################################################################
+void drawMaskTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  uint32_t seed=9;
+  auto random = [&]{seed = seed*1664525u + 1013904223u; return seed>>8;};
+
+  const TPPixel color(200, 40, 90, 180);
+
+  // The word wide mask test and the packed blend match a per channel blend, including row tails.
+  for(size_t w : {1, 7, 9, 64, 253})
+  {
+    tp_image_utils::ColorMap image;
+    tp_image_utils::ByteMap mask;
+    image.setSize(w, 13);
+    mask.setSize(w, 13);
+    for(size_t i=0; i<image.size(); i++)
+    {
+      uint32_t r = random();
+      image.data()[i] = TPPixel(uint8_t(r), uint8_t(r>>4), uint8_t(r>>8), uint8_t(r>>12));
+      mask.data()[i] = uint8_t((r>>16)%4);
+    }
+
+    for(uint8_t opacity : {0, 1, 127, 128, 254, 255})
+    {
+      tp_image_utils::ColorMap result = image;
+      TP_CHECK(drawMaskBlend(result, color, mask, 2, opacity));
+
+      bool same=true;
+      for(size_t i=0; i<image.size(); i++)
+      {
+        TPPixel s = image.constData()[i];
+        TPPixel d = result.constData()[i];
+        if(mask.constData()[i]!=2)
+        {
+          same = same && d.r==s.r && d.g==s.g && d.b==s.b && d.a==s.a;
+          continue;
+        }
+
+        same = same &&
+               d.r==blendChannel(s.r, color.r, opacity) &&
+               d.g==blendChannel(s.g, color.g, opacity) &&
+               d.b==blendChannel(s.b, color.b, opacity) &&
+               d.a==blendChannel(s.a, color.a, opacity);
+      }
+      TP_CHECK(same);
+    }
+  }
+
+  // Full opacity writes the color unchanged and mismatched sizes are rejected.
+  tp_image_utils::ColorMap image;
+  tp_image_utils::ByteMap mask;
+  image.setSize(10, 3);
+  mask.setSize(10, 3);
+  image.fill(TPPixel(1, 2, 3, 4));
+  for(size_t i=0; i<mask.size(); i++)
+    mask.data()[i] = uint8_t(i%2);
+  TP_CHECK(drawMaskBlend(image, color, mask, 1, 255));
+  TPPixel hit = image.constData()[1];
+  TPPixel miss = image.constData()[0];
+  TP_CHECK(hit.r==color.r && hit.g==color.g && hit.b==color.b && hit.a==color.a);
+  TP_CHECK(miss.r==1 && miss.g==2 && miss.b==3 && miss.a==4);
+
+  mask.setSize(9, 3);
+  TP_CHECK(!drawMaskBlend(image, color, mask, 1, 255));
+}
+
+}
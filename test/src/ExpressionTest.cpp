@@ -0,0 +1,167 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/Expression.h"
+#include "tp_pipeline_image_utils/functions/PixelManipulation.h"
+
+#include <cmath>
+
+namespace tp_pipeline_image_utils_test
+{
+
+namespace
+{
+constexpr size_t lanes = tp_pipeline_image_utils::CompiledExpression::lanes;
+
+//##################################################################################################
+//! Run an expression over lanes values of its variables, each variable v takes values[v][l].
+std::vector<float> run(const std::string& text, const std::vector<std::vector<float>>& values, std::string& error)
+{
+  auto program = tp_pipeline_image_utils::CompiledExpression::compile(text, error);
+  if(!program)
+    return {};
+
+  std::vector<const float*> inputs;
+  for(size_t v=0; v<program->variables().size(); v++)
+    inputs.push_back(values.at(v).data());
+
+  std::vector<float> scratch(program->scratchSize());
+  std::vector<float> result(lanes);
+  program->run(inputs.data(), scratch.data(), result.data());
+  return result;
+}
+
+//##################################################################################################
+uint8_t toByte(float v)
+{
+  if(!(v>0.0f))
+    return 0;
+  if(v>=255.0f)
+    return 255;
+  return uint8_t(v+0.5f);
+}
+}
+
+//##################################################################################################
+void expressionTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  std::vector<std::vector<float>> values(2, std::vector<float>(lanes));
+  for(size_t l=0; l<lanes; l++)
+  {
+    values[0][l] = float(l) - 5.0f;
+    values[1][l] = float(l%4);
+  }
+
+  // Each operator matches direct evaluation, including precedence and division by zero.
+  struct Case
+  {
+    const char* text;
+    float(*direct)(float a, float b);
+  };
+
+  const Case cases[] =
+  {
+    {"a + b * 2 - 1"             , [](float a, float b){return a + b*2.0f - 1.0f;                         }},
+    {"(a + b) * 2"               , [](float a, float b){return (a + b)*2.0f;                              }},
+    {"a / b"                     , [](float a, float b){return (b!=0.0f)?a/b:0.0f;                        }},
+    {"a % b"                     , [](float a, float b){return (b!=0.0f)?std::fmod(a, b):0.0f;            }},
+    {"-a + !b"                   , [](float a, float b){return -a + ((b==0.0f)?1.0f:0.0f);                }},
+    {"a < b || a >= 3 && b != 1" , [](float a, float b){return (a<b || (a>=3.0f && b!=1.0f))?1.0f:0.0f;   }},
+    {"a == b ? 10 : a <= b"      , [](float a, float b){return (a==b)?10.0f:((a<=b)?1.0f:0.0f);           }},
+    {"min(a, b) + max(a, b)"     , [](float a, float b){return std::min(a, b) + std::max(a, b);           }},
+    {"clamp(a, 0, b)"            , [](float a, float b){return std::min(std::max(a, 0.0f), b);            }},
+    {"abs(a) + sqrt(b) + floor(a / 3)", [](float a, float b){return std::fabs(a) + std::sqrt(b) + std::floor(a/3.0f);}},
+    {"sqrt(a)"                   , [](float a, float  ){return std::sqrt(std::max(0.0f, a));              }}
+  };
+
+  for(const auto& c : cases)
+  {
+    std::string error;
+    std::vector<float> result = run(c.text, values, error);
+    TP_CHECK(error.empty() && result.size()==lanes);
+
+    bool same = result.size()==lanes;
+    for(size_t l=0; l<lanes && same; l++)
+      same = result[l]==c.direct(values[0][l], values[1][l]);
+    TP_CHECK(same);
+  }
+
+  // Constant expressions are folded and variables are listed in order of first use.
+  {
+    std::string error;
+    auto program = CompiledExpression::compile("b + 2*3 - a + b", error);
+    TP_CHECK(program && program->variables()==std::vector<std::string>({"b", "a"}));
+
+    std::vector<float> result = run("1.5 * 4 + min(2, 7)", {}, error);
+    TP_CHECK(result.size()==lanes && result.front()==8.0f && result.back()==8.0f);
+  }
+
+  // Unsupported syntax fails to compile with an error.
+  for(const char* text : {"a +", "pow(a, 2)", "min(a)", "(a", "a $ b", "1..2"})
+  {
+    std::string error;
+    TP_CHECK(!CompiledExpression::compile(text, error) && !error.empty());
+  }
+
+  // Pixel expressions read channels of the default and named inputs.
+  tp_image_utils::ColorMap color;
+  color.setSize(37, 5);
+  tp_image_utils::ByteMap mask;
+  mask.setSize(37, 5);
+  for(size_t i=0; i<color.size(); i++)
+  {
+    color.data()[i] = TPPixel(uint8_t(i*3), uint8_t(i*7), uint8_t(i*11), uint8_t(i));
+    mask.data()[i] = uint8_t(i*13);
+  }
+
+  std::vector<PixelInput> inputs{{std::string(), &color}, {"mask", &mask}};
+
+  PixelExpressions expressions;
+  expressions.calcRed   = "blue";
+  expressions.calcGreen = "red + mask.byte";
+  expressions.calcBlue  = "x*4 + y";
+  expressions.calcAlpha = "mask.alpha";
+  expressions.calcByte  = "byte - mask.byte/2";
+
+  std::vector<std::string> errors;
+  tp_image_utils::ColorMap colorResult = compiledPixelManipulationColor(inputs, expressions, errors);
+  tp_image_utils::ByteMap byteResult = compiledPixelManipulationByte(inputs, expressions, errors);
+  TP_CHECK(errors.empty());
+  TP_CHECK(colorResult.width()==color.width() && colorResult.height()==color.height());
+  TP_CHECK(byteResult.width()==color.width() && byteResult.height()==color.height());
+
+  bool same = errors.empty();
+  for(size_t y=0; y<color.height() && same; y++)
+  {
+    for(size_t x=0; x<color.width() && same; x++)
+    {
+      size_t i = y*color.width()+x;
+      TPPixel s = color.constData()[i];
+      TPPixel d = colorResult.constData()[i];
+      float m = float(mask.constData()[i]);
+      float byte = float(int(s.r)+int(s.g)+int(s.b))/3.0f;
+
+      same = d.r==s.b &&
+             d.g==toByte(float(s.r) + m) &&
+             d.b==toByte(float(x*4 + y)) &&
+             d.a==255 &&
+             byteResult.constData()[i]==toByte(byte - m/2.0f);
+    }
+  }
+  TP_CHECK(same);
+
+  // Unknown variables and mismatched sizes are reported.
+  errors.clear();
+  expressions.calcByte = "other.byte";
+  compiledPixelManipulationByte(inputs, expressions, errors);
+  TP_CHECK(!errors.empty());
+
+  errors.clear();
+  expressions.calcByte = "byte";
+  mask.setSize(36, 5);
+  compiledPixelManipulationByte(inputs, expressions, errors);
+  TP_CHECK(!errors.empty());
+}
+
+}
@@ -0,0 +1,88 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/Gradient.h"
+
+#include <algorithm>
+
+namespace tp_pipeline_image_utils_test
+{
+
+//##################################################################################################
+void gradientTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  tp_image_utils::ColorMap color;
+  color.setSize(67, 41);
+  uint32_t seed=5;
+  for(size_t y=0; y<color.height(); y++)
+  {
+    for(size_t x=0; x<color.width(); x++)
+    {
+      seed = seed*1664525u + 1013904223u;
+      uint8_t noise = uint8_t(seed>>28);
+      bool inside = x>=20 && x<45 && y>=10 && y<30;
+      color.data()[y*color.width()+x] = inside?TPPixel(uint8_t(200+noise), 90, uint8_t(30+noise)):TPPixel(noise, 10, 20);
+    }
+  }
+
+  tp_image_utils::ByteMap gray;
+  gray.setSize(color.width(), color.height());
+  for(size_t i=0; i<color.size(); i++)
+  {
+    TPPixel p = color.constData()[i];
+    gray.data()[i] = uint8_t((int(p.r) + int(p.g) + int(p.b)) / 3);
+  }
+
+  auto same = [](const tp_image_utils::ByteMap& a, const tp_image_utils::ByteMap& b)
+  {
+    return a.width()==b.width() && a.height()==b.height() && std::equal(a.constData(), a.constData()+a.size(), b.constData());
+  };
+
+  auto count = [](const tp_image_utils::ByteMap& a)
+  {
+    return size_t(std::count(a.constData(), a.constData()+a.size(), uint8_t(255)));
+  };
+
+  // Reading color as gray a row at a time matches detection on a converted copy.
+  for(auto mode : {BorderMode::Constant, BorderMode::Clamp, BorderMode::Reflect})
+  {
+    for(auto feature : {GradientFeature::Edge, GradientFeature::Corner})
+    {
+      GradientSource fromColor;
+      fromColor.color = &color;
+      fromColor.gray = true;
+      fromColor.border = 3;
+      fromColor.mode = mode;
+      fromColor.fillColor = TPPixel(30, 60, 90);
+
+      GradientSource fromGray;
+      fromGray.byte = &gray;
+      fromGray.border = 3;
+      fromGray.mode = mode;
+      fromGray.fillValue = 60;
+
+      tp_image_utils::ByteMap a = sobelDetect(fromColor, feature, 20);
+      tp_image_utils::ByteMap b = sobelDetect(fromGray, feature, 20);
+      TP_CHECK(a.width()==color.width()+6 && a.height()==color.height()+6);
+      TP_CHECK(same(a, b));
+    }
+  }
+
+  // The corners of the square are found and the flat background is not.
+  GradientSource src;
+  src.byte = &gray;
+  tp_image_utils::ByteMap corners = sobelDetect(src, GradientFeature::Corner, 20);
+  TP_CHECK(corners.constData()[10*corners.width()+20]==255);
+  TP_CHECK(corners.constData()[29*corners.width()+44]==255);
+  TP_CHECK(corners.constData()[20*corners.width()+5]==0);
+
+  // Edges outline the square and a threshold above the step finds nothing.
+  tp_image_utils::ByteMap edges = sobelDetect(src, GradientFeature::Edge, 20);
+  TP_CHECK(edges.constData()[20*edges.width()+20]==255);
+  TP_CHECK(edges.constData()[20*edges.width()+32]==0);
+  TP_CHECK(count(edges)>count(corners));
+  TP_CHECK(count(sobelDetect(src, GradientFeature::Edge, 255))==0);
+}
+
+}
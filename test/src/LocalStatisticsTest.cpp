@@ -0,0 +1,98 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/LocalStatistics.h"
+
+#include <algorithm>
+#include <array>
+
+namespace tp_pipeline_image_utils_test
+{
+
+namespace
+{
+//##################################################################################################
+//! Collect the clipped window around each pixel and compute the statistic directly.
+tp_image_utils::ByteMap referenceStatistic(const tp_image_utils::ByteMap& src,
+                                           size_t radius,
+                                           tp_pipeline_image_utils::LocalStatistic statistic)
+{
+  using namespace tp_pipeline_image_utils;
+
+  auto r = int64_t(radius);
+  auto w = int64_t(src.width());
+  auto h = int64_t(src.height());
+
+  tp_image_utils::ByteMap dst;
+  dst.setSize(src.width(), src.height());
+  std::vector<uint8_t> values;
+  for(int64_t y=0; y<h; y++)
+  {
+    for(int64_t x=0; x<w; x++)
+    {
+      values.clear();
+      for(int64_t wy=std::max(int64_t(0), y-r); wy<=std::min(h-1, y+r); wy++)
+        for(int64_t wx=std::max(int64_t(0), x-r); wx<=std::min(w-1, x+r); wx++)
+          values.push_back(src.constData()[wy*w+wx]);
+
+      uint8_t result=0;
+      switch(statistic)
+      {
+      case LocalStatistic::Mean:
+      {
+        uint64_t sum=0;
+        for(auto v : values)
+          sum += v;
+        result = uint8_t((sum + values.size()/2) / values.size());
+        break;
+      }
+
+      case LocalStatistic::Median:
+        std::sort(values.begin(), values.end());
+        result = values.at((values.size()+1)/2-1);
+        break;
+
+      default:
+      {
+        std::array<size_t, 256> counts{};
+        for(auto v : values)
+          counts[v]++;
+        result = uint8_t(std::max_element(counts.begin(), counts.end())-counts.begin());
+        break;
+      }
+      }
+
+      dst.data()[y*w+x] = result;
+    }
+  }
+  return dst;
+}
+}
+
+//##################################################################################################
+void localStatisticsTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  // Few distinct values so that the mode is meaningful, and rows long enough for several strips.
+  tp_image_utils::ByteMap src;
+  src.setSize(301, 67);
+  uint32_t seed=13;
+  for(size_t i=0; i<src.size(); i++)
+  {
+    seed = seed*1664525u + 1013904223u;
+    src.data()[i] = uint8_t(((seed>>24)%9)*29 + (i%301)/40);
+  }
+
+  for(size_t radius : {0, 1, 4, 70})
+  {
+    for(auto statistic : {LocalStatistic::Mean, LocalStatistic::Median, LocalStatistic::Mode})
+    {
+      tp_image_utils::ByteMap result = localStatistic(src, radius, statistic);
+      tp_image_utils::ByteMap expected = referenceStatistic(src, radius, statistic);
+      TP_CHECK(result.width()==src.width() && result.height()==src.height());
+      TP_CHECK(std::equal(result.constData(), result.constData()+result.size(), expected.constData()));
+    }
+  }
+}
+
+}
@@ -0,0 +1,75 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/Palette.h"
+
+namespace tp_pipeline_image_utils_test
+{
+
+namespace
+{
+//##################################################################################################
+bool samePixel(TPPixel a, TPPixel b)
+{
+  return a.r==b.r && a.g==b.g && a.b==b.b && a.a==b.a;
+}
+}
+
+//##################################################################################################
+void paletteTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  const TPPixel colors[] =
+  {
+    TPPixel(  0,   0,   0),
+    TPPixel(255,   0,   0),
+    TPPixel(  0, 200,  40),
+    TPPixel( 17,  34, 255),
+    TPPixel(128, 128, 128, 64)
+  };
+
+  tp_image_utils::ColorMap image;
+  image.setSize(37, 23);
+  for(size_t i=0; i<image.size(); i++)
+    image.data()[i] = colors[(i*7 + i/37)%5];
+
+  tp_image_utils::ByteMap indices;
+  std::vector<TPPixel> palette;
+
+  // Few enough colors in separate bins are reproduced exactly.
+  TP_CHECK(quantizeColors(image, 8, indices, palette));
+  TP_CHECK(palette.size()==5);
+  TP_CHECK(indices.width()==image.width() && indices.height()==image.height());
+  bool exact=true;
+  for(size_t i=0; i<image.size() && palette.size()==5; i++)
+    exact = exact && samePixel(palette.at(indices.constData()[i]), image.constData()[i]);
+  TP_CHECK(exact);
+
+  // The palette never exceeds the requested size.
+  TP_CHECK(quantizeColors(image, 2, indices, palette));
+  TP_CHECK(palette.size()==2);
+  bool inRange=true;
+  for(size_t i=0; i<indices.size(); i++)
+    inRange = inRange && indices.constData()[i]<2;
+  TP_CHECK(inRange);
+
+  // Every index of a noisy image refers to a palette entry.
+  uint32_t seed=1;
+  for(size_t i=0; i<image.size(); i++)
+  {
+    seed = seed*1664525u + 1013904223u;
+    image.data()[i] = TPPixel(uint8_t(seed>>24), uint8_t(seed>>16), uint8_t(seed>>8), 255);
+  }
+  TP_CHECK(quantizeColors(image, 256, indices, palette));
+  TP_CHECK(!palette.empty() && palette.size()<=256);
+  inRange=true;
+  for(size_t i=0; i<indices.size(); i++)
+    inRange = inRange && indices.constData()[i]<palette.size();
+  TP_CHECK(inRange);
+
+  // Palettes that do not fit in a byte are rejected.
+  TP_CHECK(!quantizeColors(image, 0, indices, palette));
+  TP_CHECK(!quantizeColors(image, 257, indices, palette));
+}
+
+}
@@ -0,0 +1,65 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/Parallel.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace tp_pipeline_image_utils_test
+{
+
+//##################################################################################################
+void parallelTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  // Every item is visited exactly once.
+  std::vector<std::atomic<int>> visits(1000);
+  parallelFor(visits.size(), 10, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t i=begin; i<end; i++)
+      visits.at(i)++;
+  });
+
+  bool once=true;
+  for(const auto& v : visits)
+    once = once && v==1;
+  TP_CHECK(once);
+
+  // Nested calls run as a single range, on the caller's ranges as well as on the pool's.
+  std::atomic<int> nestedRanges{0};
+  std::atomic<int> wrongRanges{0};
+  parallelFor(64, 1, [&](size_t begin, size_t end, size_t)
+  {
+    for(size_t i=begin; i<end; i++)
+    {
+      parallelFor(100, 1, [&](size_t b, size_t e, size_t r)
+      {
+        nestedRanges++;
+        if(b!=0 || e!=100 || r!=0)
+          wrongRanges++;
+      });
+    }
+  });
+  TP_CHECK(nestedRanges==64);
+  TP_CHECK(wrongRanges==0);
+
+  // Exceptions are passed back to the caller.
+  bool caught=false;
+  try
+  {
+    parallelFor(100, 1, [&](size_t begin, size_t, size_t)
+    {
+      if(begin==0)
+        throw std::runtime_error("range failed");
+    });
+  }
+  catch(const std::runtime_error&)
+  {
+    caught=true;
+  }
+  TP_CHECK(caught);
+}
+
+}
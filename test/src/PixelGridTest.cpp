@@ -0,0 +1,63 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/PixelGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tp_pipeline_image_utils_test
+{
+
+//##################################################################################################
+void pixelGridTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  tp_image_utils::ByteMap cells;
+  cells.setSize(29, 19);
+  uint32_t seed=17;
+  for(size_t i=0; i<cells.size(); i++)
+  {
+    seed = seed*1664525u + 1013904223u;
+    cells.data()[i] = uint8_t(seed>>24);
+  }
+
+  // Upscale with whole and fractional cell sizes, the first cell starting at the image edge.
+  for(double period : {4.0, 7.0, 6.5, 9.25})
+  {
+    auto w = size_t(std::floor(double(cells.width())*period));
+    auto h = size_t(std::floor(double(cells.height())*period));
+    tp_image_utils::ByteMap src;
+    src.setSize(w, h);
+    for(size_t y=0; y<h; y++)
+    {
+      size_t cy = std::min(cells.height()-1, size_t(double(y)/period));
+      for(size_t x=0; x<w; x++)
+      {
+        size_t cx = std::min(cells.width()-1, size_t(double(x)/period));
+        src.data()[y*w+x] = cells.constData()[cy*cells.width()+cx];
+      }
+    }
+
+    PixelGridEstimate grid = estimatePixelGrid(src);
+    TP_CHECK(std::fabs(grid.x.period-period)<0.05);
+    TP_CHECK(std::fabs(grid.y.period-period)<0.05);
+    TP_CHECK(std::fabs(grid.x.start)<0.5 && std::fabs(grid.y.start)<0.5);
+    TP_CHECK(grid.x.cells==cells.width() && grid.y.cells==cells.height());
+
+    // Sampling the middle of each cell recovers the original pixels.
+    tp_image_utils::ByteMap sampled = samplePixelGrid(src, grid);
+    TP_CHECK(sampled.width()==cells.width() && sampled.height()==cells.height());
+    TP_CHECK(sampled.size()==cells.size() && std::equal(sampled.constData(), sampled.constData()+sampled.size(), cells.constData()));
+  }
+
+  // Images without a grid keep one cell per pixel.
+  tp_image_utils::ByteMap flat;
+  flat.setSize(40, 30);
+  std::fill(flat.data(), flat.data()+flat.size(), uint8_t(77));
+  PixelGridEstimate grid = estimatePixelGrid(flat);
+  TP_CHECK(grid.x.cells==40 && grid.y.cells==30);
+  TP_CHECK(grid.x.period==1.0 && grid.y.period==1.0);
+}
+
+}
@@ -0,0 +1,115 @@
+#include "Check.h"
+
+#include "tp_pipeline_image_utils/functions/Rasterise.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tp_pipeline_image_utils_test
+{
+
+namespace
+{
+//##################################################################################################
+struct Line
+{
+  float x0;
+  float y0;
+  float x1;
+  float y1;
+  TPPixel color;
+  float width;
+};
+
+//##################################################################################################
+//! Test every pixel against every line in order.
+void referenceDraw(tp_image_utils::ColorMap& dst, const std::vector<Line>& lines)
+{
+  for(const auto& l : lines)
+  {
+    double r = std::max(0.5, double(l.width)*0.5);
+    double dx = double(l.x1)-double(l.x0);
+    double dy = double(l.y1)-double(l.y0);
+    double lengthSquared = dx*dx + dy*dy;
+
+    for(size_t y=0; y<dst.height(); y++)
+    {
+      for(size_t x=0; x<dst.width(); x++)
+      {
+        double px = double(x)-double(l.x0);
+        double py = double(y)-double(l.y0);
+        double t = (lengthSquared>0.0)?std::min(1.0, std::max(0.0, (px*dx + py*dy)/lengthSquared)):0.0;
+        double ex = px - dx*t;
+        double ey = py - dy*t;
+        if(ex*ex + ey*ey <= r*r)
+          dst.data()[y*dst.width()+x] = l.color;
+      }
+    }
+  }
+}
+}
+
+//##################################################################################################
+void rasteriseTest()
+{
+  using namespace tp_pipeline_image_utils;
+
+  uint32_t seed=11;
+  auto random = [&](float lo, float hi)
+  {
+    seed = seed*1664525u + 1013904223u;
+    return lo + (hi-lo)*float(seed>>8)/float(1u<<24);
+  };
+
+  // Lines cross band boundaries, leave the image, overlap and include points.
+  std::vector<Line> lines;
+  for(size_t i=0; i<300; i++)
+  {
+    Line l;
+    l.x0 = random(-40.0f, 240.0f);
+    l.y0 = random(-40.0f, 190.0f);
+    bool point = (i%25)==0;
+    l.x1 = point?l.x0:random(-40.0f, 240.0f);
+    l.y1 = point?l.y0:random(-40.0f, 190.0f);
+    l.color = TPPixel(uint8_t(i), uint8_t(i*7), uint8_t(i*13));
+    l.width = (i%3)?1.0f:random(0.2f, 9.0f);
+    lines.push_back(l);
+  }
+
+  tp_image_utils::ColorMap expected;
+  expected.setSize(201, 151);
+  expected.fill(TPPixel(1, 2, 3));
+  tp_image_utils::ColorMap batched = expected;
+
+  referenceDraw(expected, lines);
+
+  LineBatch batch;
+  TP_CHECK(batch.empty());
+  for(const auto& l : lines)
+    batch.addLine(l.x0, l.y0, l.x1, l.y1, l.color, l.width);
+  TP_CHECK(!batch.empty());
+  batch.draw(batched);
+
+  size_t differences=0;
+  for(size_t i=0; i<expected.size(); i++)
+  {
+    TPPixel a = expected.constData()[i];
+    TPPixel b = batched.constData()[i];
+    if(a.r!=b.r || a.g!=b.g || a.b!=b.b || a.a!=b.a)
+      differences++;
+  }
+  TP_CHECK(differences==0);
+
+  // A polyline adds one line per pair of points.
+  tp_image_utils::ColorMap polyline;
+  polyline.setSize(20, 20);
+  polyline.fill(TPPixel(0, 0, 0));
+  LineBatch polylineBatch;
+  polylineBatch.addLine(tp_image_utils::Line{{2, 2}, {17, 2}, {17, 17}}, TPPixel(255, 0, 0));
+  polylineBatch.draw(polyline);
+  TP_CHECK(polyline.constData()[2*20+10].r==255);
+  TP_CHECK(polyline.constData()[10*20+17].r==255);
+  TP_CHECK(polyline.constData()[10*20+10].r==0);
+}
+
+}
@@ -0,0 +1,38 @@
+#include "Check.h"
+
+namespace tp_pipeline_image_utils_test
+{
+
+//##################################################################################################
+int& failures()
+{
+  static int failures{0};
+  return failures;
+}
+
+}
+
+//##################################################################################################
+int main()
+{
+  using namespace tp_pipeline_image_utils_test;
+
+  bitwiseTest();
+  cellSegmentTest();
+  contoursTest();
+  drawMaskTest();
+  expressionTest();
+  gradientTest();
+  localStatisticsTest();
+  paletteTest();
+  parallelTest();
+  pixelGridTest();
+  rasteriseTest();
+
+  if(failures())
+    std::cerr << failures() << " checks failed." << std::endl;
+  else
+    std::cout << "All checks passed." << std::endl;
+
+  return failures()?1:0;
+}
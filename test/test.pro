@@ -0,0 +1,3 @@
+include(vars.pri)
+include(dependencies.pri)
+include(../../tdp_build/qmake/project_tp.pri)
@@ -0,0 +1,18 @@
+TARGET = tp_pipeline_image_utils_test
+TEMPLATE = app
+CONFIG += console
+
+SOURCES += src/main.cpp
+HEADERS += src/Check.h
+
+SOURCES += src/BitwiseTest.cpp
+SOURCES += src/CellSegmentTest.cpp
+SOURCES += src/ContoursTest.cpp
+SOURCES += src/DrawMaskTest.cpp
+SOURCES += src/ExpressionTest.cpp
+SOURCES += src/GradientTest.cpp
+SOURCES += src/LocalStatisticsTest.cpp
+SOURCES += src/PaletteTest.cpp
+SOURCES += src/ParallelTest.cpp
+SOURCES += src/PixelGridTest.cpp
+SOURCES += src/RasteriseTest.cpp
@@ -6,6 +6,71 @@ DEFINES += TP_PIPELINE_IMAGE_UTILS_LIBRARY
 SOURCES += src/Globals.cpp
 HEADERS += inc/tp_pipeline_image_utils/Globals.h
 
+SOURCES += src/ImageMembers.cpp
+HEADERS += inc/tp_pipeline_image_utils/ImageMembers.h
+
+SOURCES += src/Parallel.cpp
+HEADERS += inc/tp_pipeline_image_utils/Parallel.h
+
+#-- Members ----------------------------------------------------------------------------------------
+SOURCES += src/members/IndexedImageMember.cpp
+HEADERS += inc/tp_pipeline_image_utils/members/IndexedImageMember.h
+
+SOURCES += src/members/LabelMapMember.cpp
+HEADERS += inc/tp_pipeline_image_utils/members/LabelMapMember.h
+
+SOURCES += src/members/PaddedImageMember.cpp
+HEADERS += inc/tp_pipeline_image_utils/members/PaddedImageMember.h
+
+SOURCES += src/members/FloatMapMember.cpp
+HEADERS += inc/tp_pipeline_image_utils/members/FloatMapMember.h
+
+#-- Functions ----------------------------------------------------------------------------------------
+SOURCES += src/functions/LocalStatistics.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/LocalStatistics.h
+
+SOURCES += src/functions/ExtractGrid.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/ExtractGrid.h
+
+SOURCES += src/functions/CellSegment.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/CellSegment.h
+
+SOURCES += src/functions/Expression.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/Expression.h
+
+SOURCES += src/functions/PixelManipulation.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/PixelManipulation.h
+
+SOURCES += src/functions/Bitwise.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/Bitwise.h
+
+SOURCES += src/functions/Border.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/Border.h
+
+SOURCES += src/functions/Gradient.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/Gradient.h
+
+SOURCES += src/functions/HoughLines.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/HoughLines.h
+
+SOURCES += src/functions/JoinSegments.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/JoinSegments.h
+
+SOURCES += src/functions/Rasterise.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/Rasterise.h
+
+SOURCES += src/functions/DrawMask.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/DrawMask.h
+
+SOURCES += src/functions/PixelGrid.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/PixelGrid.h
+
+SOURCES += src/functions/Contours.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/Contours.h
+
+SOURCES += src/functions/Palette.cpp
+HEADERS += inc/tp_pipeline_image_utils/functions/Palette.h
+
 #-- Delegates --------------------------------------------------------------------------------------
 SOURCES += src/step_delegates/LoadFilesStepDelegate.cpp
 HEADERS += inc/tp_pipeline_image_utils/step_delegates/LoadFilesStepDelegate.h